@@ -1,29 +1,39 @@
 ARCH := arch
-SOC:=$(ARCH)/arm32/mach-t113s3
+# Drivers shared by the sunxi SoCs, configured by the SoC's soc.h
+SUNXI := $(ARCH)/arm32/sunxi
 
-INCLUDE_DIRS += -I $(ARCH)/arm32/include -I $(SOC)/include -I $(SOC) -I $(SOC)/mmc
+# Per SoC: the directory with soc.h and link.ld, and the one with its DRAM and CCU code
+SOC_DIR_t113s3	:= $(ARCH)/arm32/mach-t113s3
+SOC_CODE_t113s3 := $(ARCH)/arm32/mach-t113s3
+SOC_DIR_t113s4	:= $(ARCH)/arm32/mach-t113s4
+SOC_CODE_t113s4 := $(ARCH)/arm32/mach-t113s3
+SOC_DIR_v851s	:= $(ARCH)/arm32/mach-v851s
+SOC_CODE_v851s	:= $(ARCH)/arm32/mach-v851s
+
+# DRAM init run by xfel before a FEL boot
+XFEL_DDR_t113s3	:= t113-s3
+XFEL_DDR_t113s4	:= t113-s4
+XFEL_DDR_v851s	:= v851s
+
+# $(1): SoC name
+ARCH_INCLUDE_DIRS = -I $(ARCH)/arm32/include -I $(SOC_DIR_$(1)) -I $(SOC_CODE_$(1)) -I $(SUNXI)
+ARCH_SRCS = $(SOC_CODE_$(1))/dram.c $(SOC_CODE_$(1))/sunxi_clk.c $(SUNXI_SRCS)
 
 CFLAGS += -DCOUNTER_FREQUENCY=24000000
 
-SRCS	+=  $(SOC)/dram.c
-ASRCS	+=  $(SOC)/start.S
-ASRCS	+=  $(SOC)/memcpy.S
-
-SRCS	+=  $(SOC)/sunxi_usart.c
-SRCS	+=  $(SOC)/arch_timer.c
-SRCS	+=  $(SOC)/sunxi_gpio.c
-SRCS	+=  $(SOC)/sunxi_clk.c
-SRCS	+=  $(SOC)/exception.c
-SRCS	+=  $(SOC)/sunxi_wdg.c
-
-USE_SPI = $(shell grep -E "^\#define CONFIG_BOOT_SPI" board.h)
-ifneq ($(USE_SPI),)
-SRCS	+=  $(SOC)/sunxi_spi.c
-SRCS	+=  $(SOC)/sunxi_dma.c
-endif
-
-USE_SDMMC = $(shell grep -E "^\#define CONFIG_BOOT_(SDCARD|MMC)" board.h)
-ifneq ($(USE_SDMMC),)
-SRCS	+=  $(SOC)/sdmmc.c
-SRCS	+=  $(SOC)/sunxi_sdhci.c
-endif
+ASRCS	+=  $(SUNXI)/start.S
+ASRCS	+=  $(SUNXI)/memcpy.S
+
+SUNXI_SRCS	+=  $(SUNXI)/sunxi_usart.c
+SUNXI_SRCS	+=  $(SUNXI)/arch_timer.c
+SUNXI_SRCS	+=  $(SUNXI)/sunxi_gpio.c
+SUNXI_SRCS	+=  $(SUNXI)/exception.c
+SUNXI_SRCS	+=  $(SUNXI)/sunxi_wdg.c
+SUNXI_SRCS	+=  $(SUNXI)/sunxi_dma.c
+SUNXI_SRCS	+=  $(SUNXI)/memtest.c
+
+# Boot media drivers, picked by the variant
+SPI_SRCS	+=  $(SUNXI)/sunxi_spi.c
+
+SDMMC_SRCS	+=  $(SUNXI)/sdmmc.c
+SDMMC_SRCS	+=  $(SUNXI)/sunxi_sdhci.c
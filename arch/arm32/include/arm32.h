@@ -82,6 +82,18 @@ static inline void arm32_icache_disable(void)
 	arm32_write_p15_c1(value & ~(1 << 12));
 }
 
+// Invalidate the whole I-cache and the branch predictor, after writing code
+static inline void arm32_icache_invalidate(void)
+{
+	__asm__ __volatile__("mcr p15, 0, %0, c7, c5, 0\n" // ICIALLU
+						 "mcr p15, 0, %0, c7, c5, 6\n" // BPIALL
+						 "dsb\n"
+						 "isb"
+						 :
+						 : "r"(0)
+						 : "memory");
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,7 +5,12 @@
 extern "C" {
 #endif
 
-#if __ARM32_ARCH__ == 5
+#if defined(CONFIG_IO_MODEL)
+/* Host builds, see tools/regsim: only the compiler may reorder */
+#define isb() __asm__ __volatile__("" : : : "memory")
+#define dsb() __asm__ __volatile__("" : : : "memory")
+#define dmb() __asm__ __volatile__("" : : : "memory")
+#elif __ARM32_ARCH__ == 5
 #define isb() __asm__ __volatile__("" : : : "memory")
 #define dsb() __asm__ __volatile__("mcr p15, 0, %0, c7, c10,  4" : : "r"(0) : "memory")
 #define dmb() __asm__ __volatile__("" : : : "memory")
@@ -19,6 +19,9 @@
 #include "reg-dram.h"
 #include "common.h"
 #include "board.h"
+#include "memtest.h"
+#include "sunxi_wdg.h"
+#include "soc.h"
 
 #define readl(addr) read32(addr)
 #define writel(val, addr) write32((addr), (val))
@@ -32,14 +35,6 @@
 
 #define CONFIG_SYS_SDRAM_BASE SDRAM_BASE
 
-#define CONFIG_DRAM_CLK 792
-#define CONFIG_SUNXI_DRAM_TYPE 3
-#define CONFIG_DRAM_ZQ 0x7b7bfb
-#define CONFIG_DRAM_SUNXI_ODT_EN 0x00
-#define CONFIG_DRAM_SUNXI_TPR11 0x00340000
-#define CONFIG_DRAM_SUNXI_TPR12 0x00000046
-#define CONFIG_DRAM_SUNXI_TPR13 0x34000100
-
 #ifndef SUNXI_SID_BASE
 #define SUNXI_SID_BASE 0x3006200
 #endif
@@ -1411,34 +1406,250 @@ int init_DRAM(int type, dram_para_t *para)
 	return mem_size_mb;
 }
 
+static dram_info_t dram_info;
+
+/* Geometry as programmed in the controller by the final mctl_core_init() */
+static void dram_get_geometry(dram_para_t *para, unsigned int size_mb)
+{
+	uint32_t val = readl((MCTL_COM_BASE + MCTL_COM_WORK_MODE0));
+
+	dram_info.size_mb	= size_mb;
+	dram_info.clk		= para->dram_clk;
+	dram_info.type		= para->dram_type;
+	dram_info.width		= (val & BIT(12)) ? 32 : 16;
+	dram_info.banks		= 4 << ((val >> 2) & 0x3);
+	dram_info.row_bits	= ((val >> 4) & 0xf) + 1;
+	dram_info.page_size = 8 << ((val >> 8) & 0xf);
+	dram_info.ranks		= (val & 0x3) ? 2 : 1;
+
+	dram_info.rank_mb[0] = calculate_rank_size(val);
+	dram_info.rank_mb[1] = 0;
+	if (dram_info.ranks == 2)
+		dram_info.rank_mb[1] = size_mb - dram_info.rank_mb[0];
+
+	debug("DRAM: %u rank(s) x%u, %u banks, %u row bits, %uB pages\r\n", dram_info.ranks, dram_info.width,
+		  dram_info.banks, dram_info.row_bits, dram_info.page_size);
+}
+
+/* What dqs_gate_detect() and eye_delay_compensation() left behind */
+static void dram_get_training(dram_para_t *para)
+{
+	dram_info.para2			 = para->dram_para2;
+	dram_info.eye_delay[0]	 = para->dram_tpr10;
+	dram_info.eye_delay[1]	 = para->dram_tpr11;
+	dram_info.eye_delay[2]	 = para->dram_tpr12;
+	dram_info.gate_status[0] = readl(MCTL_PHY_BASE + MCTL_PHY_DXnGSR0(0));
+	dram_info.gate_status[1] = readl(MCTL_PHY_BASE + MCTL_PHY_DXnGSR0(1));
+
+	info("DRAM: profile %s, %uMHz, %uMB\r\n", dram_info.profile, dram_info.clk, dram_info.size_mb);
+	debug("DRAM: para2=0x%x, eye delay 0x%x 0x%x 0x%x, gate status 0x%x 0x%x\r\n", dram_info.para2,
+		  dram_info.eye_delay[0], dram_info.eye_delay[1], dram_info.eye_delay[2], dram_info.gate_status[0],
+		  dram_info.gate_status[1]);
+}
+
+const dram_info_t *sunxi_dram_get_info(void)
+{
+	return &dram_info;
+}
+
+/*
+ * The auto scan result is kept in RTC general purpose registers, they
+ * survive warm resets. RTC_BKP_REG 0-2 hold the slot boot counters.
+ * The check covers the profile, so it also tells which one was used.
+ */
+#define DRAM_SCAN_REG	4 // para1, para2, tpr13, check
+#define DRAM_SCAN_MAGIC 0x5343414e
+
+static uint32_t dram_scan_check(unsigned int profile, uint32_t para1, uint32_t para2, uint32_t tpr13)
+{
+	const dram_para_t *para	   = &dram_profiles[profile].para;
+	const uint32_t	   words[] = {profile, para1, para2, tpr13, para->dram_clk, para->dram_type, para->dram_tpr13};
+	uint32_t		   hash	   = DRAM_SCAN_MAGIC;
+	unsigned int	   i;
+
+	for (i = 0; i < ARRAY_SIZE(words); i++) {
+		hash ^= words[i];
+		hash *= 0x01000193;
+	}
+
+	return hash;
+}
+
+static int dram_scan_load(dram_para_t *para)
+{
+	uint32_t	 para1 = RTC_BKP_REG(DRAM_SCAN_REG);
+	uint32_t	 para2 = RTC_BKP_REG(DRAM_SCAN_REG + 1);
+	uint32_t	 tpr13 = RTC_BKP_REG(DRAM_SCAN_REG + 2);
+	unsigned int i;
+
+	for (i = 0; i < dram_profile_count; i++) {
+		if (RTC_BKP_REG(DRAM_SCAN_REG + 3) != dram_scan_check(i, para1, para2, tpr13))
+			continue;
+
+		*para			 = dram_profiles[i].para;
+		para->dram_para1 = para1;
+		para->dram_para2 = para2;
+		para->dram_tpr13 = tpr13 | BIT(0);
+
+		return i;
+	}
+
+	return -1;
+}
+
+static void dram_scan_store(unsigned int profile, const dram_para_t *para)
+{
+	RTC_BKP_REG(DRAM_SCAN_REG)	   = para->dram_para1;
+	RTC_BKP_REG(DRAM_SCAN_REG + 1) = para->dram_para2;
+	RTC_BKP_REG(DRAM_SCAN_REG + 2) = para->dram_tpr13;
+	RTC_BKP_REG(DRAM_SCAN_REG + 3) = dram_scan_check(profile, para->dram_para1, para->dram_para2, para->dram_tpr13);
+}
+
+static void dram_scan_clear(void)
+{
+	RTC_BKP_REG(DRAM_SCAN_REG + 3) = 0;
+}
+
+/* Full init with a profile, accepted when the write/read test passes */
+static unsigned int dram_try_profile(unsigned int profile, dram_para_t *para)
+{
+	unsigned int size_mb;
+
+	*para = dram_profiles[profile].para;
+	if (para->dram_clk > sunxi_soc.dram_clk_max) {
+		debug("DRAM: profile %s is above %uMHz on %s\r\n", dram_profiles[profile].name, sunxi_soc.dram_clk_max,
+			  sunxi_soc.name);
+		return 0;
+	}
+	debug("DRAM: trying profile %s\r\n", dram_profiles[profile].name);
+
+	size_mb = init_DRAM(0, para);
+	if (size_mb && dramc_simple_wr_test(size_mb, 4096) == 0)
+		return size_mb;
+
+	warning("DRAM: profile %s failed\r\n", dram_profiles[profile].name);
+
+	return 0;
+}
+
+#ifdef CONFIG_DRAM_SWEEP
+#define SWEEP_DELAYS 16 // settings of each tpr12 delay field
+
+static unsigned int dram_sweep_init(const dram_para_t *base, unsigned int clk, int delay)
+{
+	dram_para_t	 para = *base;
+	unsigned int size_mb;
+
+	para.dram_clk = clk;
+	if (delay >= 0)
+		para.dram_tpr12 = delay * 0x00110011; // same delay on both DQ groups and DQS of both lanes
+
+	size_mb = init_DRAM(0, &para);
+	if (size_mb && dramc_simple_wr_test(size_mb, 4096))
+		return 0;
+
+	return size_mb;
+}
+
+/*
+ * Characterisation: at each clock the delay fields of tpr12 are swept to
+ * measure the passing window, then the profile settings get a memory test.
+ * The fastest clock passing every step up to it, less the margin, is
+ * suggested for the dram_profiles[] entry in board.c.
+ */
+static void dram_sweep(const dram_profile_t *profile)
+{
+	memtest_result_t result;
+	char			 window[SWEEP_DELAYS + 1];
+	unsigned int	 clk, best = 0, size_mb, passed;
+	bool			 pass, contiguous = true;
+	int				 delay;
+
+	info("DRAM: sweep %u-%uMHz from profile %s\r\n", CONFIG_DRAM_SWEEP_MIN, CONFIG_DRAM_SWEEP_MAX, profile->name);
+	message(" MHz test delay window\r\n");
+
+	for (clk = CONFIG_DRAM_SWEEP_MIN; clk <= CONFIG_DRAM_SWEEP_MAX; clk += CONFIG_DRAM_SWEEP_STEP) {
+		sunxi_wdg_set(10);
+
+		passed = 0;
+		for (delay = 0; delay < SWEEP_DELAYS; delay++) {
+			pass		  = dram_sweep_init(&profile->para, clk, delay) != 0;
+			window[delay] = pass ? '#' : '.';
+			passed += pass;
+		}
+		window[SWEEP_DELAYS] = '\0';
+
+		size_mb = dram_sweep_init(&profile->para, clk, -1);
+		pass	= size_mb && memtest_run(SDRAM_BASE, 1, MEMTEST_ALL, &result) == 0;
+
+		message("%4u %s %s %u/%u\r\n", clk, pass ? "PASS" : "FAIL", window, passed, SWEEP_DELAYS);
+
+		if (pass && contiguous)
+			best = clk;
+		else
+			contiguous = false;
+	}
+
+	if (best > CONFIG_DRAM_SWEEP_MIN + CONFIG_DRAM_SWEEP_MARGIN) {
+		best = (best - CONFIG_DRAM_SWEEP_MARGIN) / 12 * 12; // PLL_DDR steps
+		info("DRAM: suggested dram_clk %uMHz for profile %s\r\n", best, profile->name);
+	} else {
+		warning("DRAM: no clock passes with %uMHz margin\r\n", CONFIG_DRAM_SWEEP_MARGIN);
+	}
+}
+#endif
+
 unsigned long sunxi_dram_init(void)
 {
-	dram_para_t para = {
-		.dram_clk = CONFIG_DRAM_CLK,
-		.dram_type = CONFIG_SUNXI_DRAM_TYPE,
-		.dram_zq = CONFIG_DRAM_ZQ,
-		.dram_odt_en = CONFIG_DRAM_SUNXI_ODT_EN,
-		.dram_para1 = 0x000010d2,
-		.dram_para2 = 0,
-		.dram_mr0 = 0x1c70,
-		.dram_mr1 = 0x42,
-		.dram_mr2 = 0x18,
-		.dram_mr3 = 0,
-		.dram_tpr0 = 0x004a2195,
-		.dram_tpr1 = 0x02423190,
-		.dram_tpr2 = 0x0008b061,
-		.dram_tpr3 = 0xb4787896, // unused
-		.dram_tpr4 = 0,
-		.dram_tpr5 = 0x48484848,
-		.dram_tpr6 = 0x00000048,
-		.dram_tpr7 = 0x1620121e, // unused
-		.dram_tpr8 = 0,
-		.dram_tpr9 = 0, // clock?
-		.dram_tpr10 = 0,
-		.dram_tpr11 = CONFIG_DRAM_SUNXI_TPR11,
-		.dram_tpr12 = CONFIG_DRAM_SUNXI_TPR12,
-		.dram_tpr13 = CONFIG_DRAM_SUNXI_TPR13,
-	};
-
-	return init_DRAM(0, &para) * 1024UL * 1024;
+	dram_para_t	 para;
+	unsigned int size_mb = 0, cached_mb, i;
+	int			 strap	 = board_get_dram_profile();
+	int			 profile;
+
+	if (strap >= (int)dram_profile_count) {
+		warning("DRAM: no profile %d\r\n", strap);
+		strap = -1;
+	}
+
+#ifdef CONFIG_DRAM_SWEEP
+	dram_scan_clear();
+	dram_sweep(&dram_profiles[strap >= 0 ? strap : 0]);
+#endif
+
+	// Reuse the last scan, then check it before trusting it
+	profile = dram_scan_load(&para);
+	if (profile >= 0 && (strap < 0 || strap == profile)) {
+		debug("DRAM: using cached scan para1=0x%x para2=0x%x\r\n", para.dram_para1, para.dram_para2);
+		cached_mb = para.dram_para2 >> 16;
+		size_mb	  = init_DRAM(0, &para);
+		if (!size_mb || size_mb != cached_mb || dramc_simple_wr_test(size_mb, 4096)) {
+			warning("DRAM: cached scan failed, scanning again\r\n");
+			size_mb = 0;
+		}
+	}
+
+	if (!size_mb) {
+		dram_scan_clear();
+
+		// The strapped profile first, then the table in order
+		profile = strap;
+		if (profile >= 0)
+			size_mb = dram_try_profile(profile, &para);
+		for (i = 0; i < dram_profile_count && !size_mb; i++) {
+			if ((int)i == strap)
+				continue;
+			profile = i;
+			size_mb = dram_try_profile(profile, &para);
+		}
+		if (!size_mb)
+			return 0;
+
+		dram_scan_store(profile, &para);
+	}
+
+	dram_info.profile = dram_profiles[profile].name;
+	dram_get_geometry(&para, size_mb);
+	dram_get_training(&para);
+
+	return size_mb * 1024UL * 1024;
 };
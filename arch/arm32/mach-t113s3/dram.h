@@ -70,7 +70,32 @@ typedef struct __DRAM_PARA {
 
 } dram_para_t;
 
-int init_DRAM(int type, dram_para_t *para);
-unsigned long sunxi_dram_init(void);
+/* What init_DRAM() found, passed on to the kernel */
+typedef struct {
+	unsigned int size_mb;
+	unsigned int ranks;
+	unsigned int rank_mb[2];
+	unsigned int width; // DQ bits
+	unsigned int banks;
+	unsigned int row_bits;
+	unsigned int page_size; // bytes
+	unsigned int clk;		// MHz
+	unsigned int type;		// enum sunxi_dram_type
+	const char	*profile;
+	// Training results
+	unsigned int para2;			 // ranks and DQ width from dqs_gate_detect()
+	unsigned int eye_delay[3];	 // tpr10-12 applied by eye_delay_compensation()
+	unsigned int gate_status[2]; // DXnGSR0 of both byte lanes
+} dram_info_t;
+
+/* A named set of timings, see dram_profiles[] in board.c */
+typedef struct {
+	const char *name;
+	dram_para_t para;
+} dram_profile_t;
+
+int				   init_DRAM(int type, dram_para_t *para);
+unsigned long	   sunxi_dram_init(void);
+const dram_info_t *sunxi_dram_get_info(void);
 
 #endif
@@ -6,13 +6,42 @@
 
 volatile ccu_reg_t *const ccu = (ccu_reg_t *)T113_CCU_BASE;
 
-void set_pll_cpux_axi(void)
+/*
+ * Clock plan: the CPU runs at CONFIG_CPU_FREQ, or the next lower step
+ * when its PLL does not lock, and each bus gets the smallest divider
+ * keeping it within the validated limit.
+ */
+#ifndef CONFIG_CPU_FREQ
+#define CONFIG_CPU_FREQ 1008000000
+#endif
+
+#define CLK_AXI_MAX			600000000
+#define CLK_PSI_MAX			200000000 // AHB, SMHC and SPI registers
+#define CLK_APB0_MAX		100000000
+#define CLK_APB1_MAX		100000000 // UART and TWI
+#define CLK_LOCK_TIMEOUT_US 1000
+
+static const uint32_t cpu_freqs[] = {CONFIG_CPU_FREQ, 1008000000, 792000000};
+
+static sunxi_clk_plan_t clk_plan;
+
+static bool clk_wait_lock(virtual_addr_t addr)
 {
-	uint32_t val;
+	uint64_t start = time_us();
 
-	/* AXI: Select cpu clock src to PLL_PERI(1x) */
-	write32(T113_CCU_BASE + CCU_CPU_AXI_CFG_REG, (4 << 24) | (1 << 0));
-	sdelay(10);
+	while (!(read32(addr) & (0x1 << 28))) {
+		if (time_us() - start > CLK_LOCK_TIMEOUT_US)
+			return false;
+	}
+	sdelay(20);
+
+	return true;
+}
+
+static bool set_pll_cpux(uint32_t freq)
+{
+	uint32_t val;
+	bool	 locked;
 
 	/* Disable pll gating */
 	val = read32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG);
@@ -25,15 +54,10 @@ void set_pll_cpux_axi(void)
 	write32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG, val);
 	sdelay(5);
 
-	/* Set clk to 1008mhz (default) or CONFIG_CPU_FREQ */
 	/* PLL_CPUX = 24 MHz*N/P */
 	val = read32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG);
 	val &= ~((0x3 << 16) | (0xff << 8) | (0x3 << 0));
-#ifdef CONFIG_CPU_FREQ
-	val |= (((CONFIG_CPU_FREQ / 24000000) - 1) << 8);
-#else
-	val |= (41 << 8);
-#endif
+	val |= (((freq / 24000000) - 1) << 8);
 	write32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG, val);
 
 	/* Lock enable */
@@ -46,15 +70,14 @@ void set_pll_cpux_axi(void)
 	val |= (1 << 31);
 	write32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG, val);
 
-	/* Wait pll stable */
-	while (!(read32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG) & (0x1 << 28)))
-		;
-	sdelay(20);
+	locked = clk_wait_lock(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG);
 
 	/* Enable pll gating */
-	val = read32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG);
-	val |= (1 << 27);
-	write32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG, val);
+	if (locked) {
+		val = read32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG);
+		val |= (1 << 27);
+		write32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG, val);
+	}
 
 	/* Lock disable */
 	val = read32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG);
@@ -62,10 +85,38 @@ void set_pll_cpux_axi(void)
 	write32(T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG, val);
 	sdelay(1);
 
-	/* AXI: set and change cpu clk src to PLL_CPUX, PLL_CPUX:AXI0 = 1200MHz:600MHz */
+	return locked;
+}
+
+static void set_pll_cpux_axi(void)
+{
+	uint32_t	 val, axi_div;
+	unsigned int i;
+
+	/* AXI: Select cpu clock src to PLL_PERI(1x) */
+	write32(T113_CCU_BASE + CCU_CPU_AXI_CFG_REG, (4 << 24) | (1 << 0));
+	sdelay(10);
+
+	clk_plan.cpu = 0;
+	for (i = 0; i < ARRAY_SIZE(cpu_freqs) && !clk_plan.cpu; i++) {
+		if (cpu_freqs[i] <= CONFIG_CPU_FREQ && set_pll_cpux(cpu_freqs[i]))
+			clk_plan.cpu = cpu_freqs[i];
+	}
+
+	/* No lock at all, stay on PLL_PERI(1x) */
+	if (!clk_plan.cpu) {
+		clk_plan.cpu = sunxi_clk_get_peri1x_rate();
+		clk_plan.axi = clk_plan.cpu / 2;
+		return;
+	}
+
+	/* AXI: set and change cpu clk src to PLL_CPUX, AXI within CLK_AXI_MAX */
+	axi_div		 = min((clk_plan.cpu + CLK_AXI_MAX - 1) / CLK_AXI_MAX, 4U);
+	clk_plan.axi = clk_plan.cpu / axi_div;
+
 	val = read32(T113_CCU_BASE + CCU_CPU_AXI_CFG_REG);
 	val &= ~(0x07 << 24 | 0x3 << 16 | 0x3 << 8 | 0xf << 0); // Clear
-	val |= (0x03 << 24 | 0x0 << 16 | 0x1 << 8 | 0x1 << 0); // CLK_SEL=PLL_CPU/P, DIVP=0, DIV2=1, DIV1=1
+	val |= (0x03 << 24 | 0x0 << 16 | 0x1 << 8 | (axi_div - 1) << 0); // CLK_SEL=PLL_CPU/P, DIVP=0, DIV2=1, DIV1
 	write32(T113_CCU_BASE + CCU_CPU_AXI_CFG_REG, val);
 	sdelay(1);
 }
@@ -92,9 +143,7 @@ static void set_pll_periph0(void)
 	write32(T113_CCU_BASE + CCU_PLL_PERI0_CTRL_REG, val);
 
 	/* Wait pll stable */
-	while (!(read32(T113_CCU_BASE + CCU_PLL_PERI0_CTRL_REG) & (0x1 << 28)))
-		;
-	sdelay(20);
+	clk_wait_lock(T113_CCU_BASE + CCU_PLL_PERI0_CTRL_REG);
 
 	/* Lock disable */
 	val = read32(T113_CCU_BASE + CCU_PLL_PERI0_CTRL_REG);
@@ -102,19 +151,26 @@ static void set_pll_periph0(void)
 	write32(T113_CCU_BASE + CCU_PLL_PERI0_CTRL_REG, val);
 }
 
-static void set_ahb(void)
+/*
+ * PSI and APB clocks: M in the low bits, N = 1/2/4/8 in bits 9:8, parent in
+ * bits 25:24. Pick the smallest M * N from PLL_PERI(1x) within limit.
+ */
+static uint32_t set_bus(virtual_addr_t addr, uint32_t m_max, uint32_t limit)
 {
-	write32(T113_CCU_BASE + CCU_PSI_CLK_REG, (2 << 0) | (0 << 8) | (0x03 << 24));
-	sdelay(1);
-}
+	uint32_t parent = sunxi_clk_get_peri1x_rate();
+	uint32_t n, m;
 
-static void set_apb(void)
-{
-  uint32_t config = (2 << 0) | (1 << 8) | (0x03 << 24); /* P=2, M=3, parent=PLL_PERI(1x) */
+	for (n = 0;; n++) {
+		m = ((parent >> n) + limit - 1) / limit;
+		if (m <= m_max || n == 3)
+			break;
+	}
+	m = min(max(m, 1U), m_max);
 
-  write32(T113_CCU_BASE + CCU_APB0_CLK_REG, config);
-  write32(T113_CCU_BASE + CCU_APB1_CLK_REG, config);
-  sdelay(1);
+	write32(addr, (m - 1) << 0 | n << 8 | (0x03 << 24));
+	sdelay(1);
+
+	return (parent >> n) / m;
 }
 
 static void set_dma(void)
@@ -154,9 +210,7 @@ static void set_module(virtual_addr_t addr)
 		write32(addr, val);
 
 		/* Wait pll stable */
-		while (!(read32(addr) & (0x1 << 28)))
-			;
-		sdelay(20);
+		clk_wait_lock(addr);
 
 		/* Lock disable */
 		val = read32(addr);
@@ -169,8 +223,9 @@ void sunxi_clk_init(void)
 {
 	set_pll_cpux_axi();
 	set_pll_periph0();
-	set_ahb();
-	set_apb();
+	clk_plan.psi  = set_bus(T113_CCU_BASE + CCU_PSI_CLK_REG, 4, CLK_PSI_MAX);
+	clk_plan.apb0 = set_bus(T113_CCU_BASE + CCU_APB0_CLK_REG, 32, CLK_APB0_MAX);
+	clk_plan.apb1 = set_bus(T113_CCU_BASE + CCU_APB1_CLK_REG, 32, CLK_APB1_MAX);
 	set_dma();
 	set_mbus();
 	set_module(T113_CCU_BASE + CCU_PLL_PERI0_CTRL_REG);
@@ -181,6 +236,11 @@ void sunxi_clk_init(void)
 	set_module(T113_CCU_BASE + CCU_PLL_AUDIO1_CTRL_REG);
 }
 
+const sunxi_clk_plan_t *sunxi_clk_get_plan(void)
+{
+	return &clk_plan;
+}
+
 uint32_t sunxi_clk_get_peri1x_rate()
 {
 	uint32_t reg32;
@@ -200,6 +260,20 @@ uint32_t sunxi_clk_get_peri1x_rate()
 }
 
 #ifdef CONFIG_ENABLE_CPU_FREQ_DUMP
+static uint32_t clk_bus_rate(uint32_t reg, uint32_t m_mask)
+{
+	uint32_t val = read32(T113_CCU_BASE + reg);
+
+	switch ((val >> 24) & 0x3) {
+		case 0x0:
+			return 24000000 / ((val & m_mask) + 1) >> ((val >> 8) & 0x3);
+		case 0x3:
+			return sunxi_clk_get_peri1x_rate() / ((val & m_mask) + 1) >> ((val >> 8) & 0x3);
+		default:
+			return 0;
+	}
+}
+
 void sunxi_clk_dump()
 {
 	uint32_t	reg32;
@@ -288,5 +362,12 @@ void sunxi_clk_dump()
 	} else {
 		debug("CLK: PLL_ddr disabled\r\n");
 	}
+
+	/* Buses, as programmed */
+	debug("CLK: AXI=%" PRIu32 "MHz PSI=%" PRIu32 "MHz APB0=%" PRIu32 "MHz APB1=%" PRIu32 "MHz\r\n",
+		  clk_plan.axi / 1000000, clk_bus_rate(CCU_PSI_CLK_REG, 0x3) / 1000000,
+		  clk_bus_rate(CCU_APB0_CLK_REG, 0x1f) / 1000000, clk_bus_rate(CCU_APB1_CLK_REG, 0x1f) / 1000000);
+	if (clk_plan.cpu != CONFIG_CPU_FREQ)
+		warning("CLK: CPU PLL did not lock at %" PRIu32 "MHz\r\n", (uint32_t)CONFIG_CPU_FREQ / 1000000);
 }
 #endif
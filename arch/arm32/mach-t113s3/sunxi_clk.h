@@ -4,9 +4,11 @@
 #include "common.h"
 #include "reg-ccu.h"
 #include "reg-r-ccu.h"
+#include "sunxi_soc.h"
 
-void	 sunxi_clk_init(void);
-uint32_t sunxi_clk_get_peri1x_rate(void);
+void					sunxi_clk_init(void);
+uint32_t				sunxi_clk_get_peri1x_rate(void);
+const sunxi_clk_plan_t *sunxi_clk_get_plan(void);
 
 void sunxi_clk_dump(void);
 
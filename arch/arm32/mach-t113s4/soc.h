@@ -0,0 +1,27 @@
+#ifndef __SOC_H__
+#define __SOC_H__
+
+#include "io.h"
+#include "sunxi_soc.h"
+#include "sunxi_gpio.h"
+
+static const sunxi_soc_t sunxi_soc = {
+	.name		  = "T113-S4",
+	.ccu_base	  = 0x02001000,
+	.gpio_base	  = 0x02000000,
+	.gpio_ports	  = BIT(PORTB) | BIT(PORTC) | BIT(PORTD) | BIT(PORTE) | BIT(PORTF) | BIT(PORTG),
+	.uart_base	  = 0x02500000,
+	.dma_base	  = 0x03002000,
+	.spi_mod_clk  = 200000000,
+	.dram_clk_max = 936,
+
+	.ccu_dma_bgr   = 0x070c,
+	.ccu_mbus_gate = 0x0804,
+	.ccu_smhc0_clk = 0x0830,
+	.ccu_smhc_bgr  = 0x084c,
+	.ccu_uart_bgr  = 0x090c,
+	.ccu_spi0_clk  = 0x0940,
+	.ccu_spi_bgr   = 0x096c,
+};
+
+#endif
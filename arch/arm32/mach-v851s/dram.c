@@ -1410,34 +1410,71 @@ int init_DRAM(int type, dram_para_t *para)
 	return mem_size_mb;
 }
 
+static dram_info_t dram_info;
+
+/* Geometry and training results as left in the controller by init_DRAM() */
+static void dram_get_info(dram_para_t *para, unsigned int size_mb)
+{
+	uint32_t val = readl((MCTL_COM_BASE + MCTL_COM_WORK_MODE0));
+
+	dram_info.size_mb	= size_mb;
+	dram_info.clk		= para->dram_clk;
+	dram_info.type		= para->dram_type;
+	dram_info.width		= (val & BIT(12)) ? 32 : 16;
+	dram_info.banks		= 4 << ((val >> 2) & 0x3);
+	dram_info.row_bits	= ((val >> 4) & 0xf) + 1;
+	dram_info.page_size = 8 << ((val >> 8) & 0xf);
+	dram_info.ranks		= (val & 0x3) ? 2 : 1;
+
+	dram_info.rank_mb[0] = calculate_rank_size(val);
+	dram_info.rank_mb[1] = 0;
+	if (dram_info.ranks == 2)
+		dram_info.rank_mb[1] = size_mb - dram_info.rank_mb[0];
+
+	dram_info.para2			 = para->dram_para2;
+	dram_info.eye_delay[0]	 = para->dram_tpr10;
+	dram_info.eye_delay[1]	 = para->dram_tpr11;
+	dram_info.eye_delay[2]	 = para->dram_tpr12;
+	dram_info.gate_status[0] = readl(MCTL_PHY_BASE + MCTL_PHY_DXnGSR0(0));
+	dram_info.gate_status[1] = readl(MCTL_PHY_BASE + MCTL_PHY_DXnGSR0(1));
+
+	info("DRAM: profile %s, %uMHz, %uMB\r\n", dram_info.profile, dram_info.clk, dram_info.size_mb);
+}
+
+const dram_info_t *sunxi_dram_get_info(void)
+{
+	return &dram_info;
+}
+
+/* The strapped profile first, then the table in order */
 unsigned long sunxi_dram_init(void)
 {
-	dram_para_t para = {
-		.dram_clk	 = 528,
-		.dram_type	 = 2,
-		.dram_zq	 = 0x7b7bf9,
-		.dram_odt_en = 0x0,
-		.dram_para1	 = 0x00d2,
-		.dram_para2	 = 0x0,
-		.dram_mr0	 = 0xe73,
-		.dram_mr1	 = 0x02,
-		.dram_mr2	 = 0x0,
-		.dram_mr3	 = 0x0,
-		.dram_tpr0	 = 0x00471992,
-		.dram_tpr1	 = 0x0131a10c,
-		.dram_tpr2	 = 0x00057041,
-		.dram_tpr3	 = 0xb4787896,
-		.dram_tpr4	 = 0x0,
-		.dram_tpr5	 = 0x48484848,
-		.dram_tpr6	 = 0x48,
-		.dram_tpr7	 = 0x1621121e,
-		.dram_tpr8	 = 0x0,
-		.dram_tpr9	 = 0x0,
-		.dram_tpr10	 = 0x00000000,
-		.dram_tpr11	 = 0x00000022,
-		.dram_tpr12	 = 0x00000077,
-		.dram_tpr13	 = 0x34000100,
-	};
-
-	return init_DRAM(0, &para) * 1024UL * 1024;
-}
\ No newline at end of file
+	dram_para_t	 para;
+	unsigned int size_mb = 0, i;
+	int			 strap	 = board_get_dram_profile();
+	int			 profile = -1;
+
+	if (strap >= (int)dram_profile_count) {
+		warning("DRAM: no profile %d\r\n", strap);
+		strap = -1;
+	}
+
+	for (i = 0; i <= dram_profile_count && !size_mb; i++) {
+		profile = i ? (int)i - 1 : strap;
+		if (profile < 0 || (i && profile == strap))
+			continue;
+
+		para = dram_profiles[profile].para;
+		debug("DRAM: trying profile %s\r\n", dram_profiles[profile].name);
+		size_mb = init_DRAM(0, &para);
+		if (!size_mb)
+			warning("DRAM: profile %s failed\r\n", dram_profiles[profile].name);
+	}
+	if (!size_mb)
+		return 0;
+
+	dram_info.profile = dram_profiles[profile].name;
+	dram_get_info(&para, size_mb);
+
+	return size_mb * 1024UL * 1024;
+}
@@ -4,6 +4,14 @@
 #include "reg-ccu.h"
 #include "debug.h"
 
+// What sunxi_clk_init() programs, APB1 is left on OSC24M
+static const sunxi_clk_plan_t clk_plan = {
+	.cpu  = 912000000,
+	.axi  = 456000000,
+	.psi  = 200000000,
+	.apb0 = 100000000,
+	.apb1 = 24000000,
+};
 
 void sunxi_clk_init(void)
 {
@@ -82,6 +90,11 @@ void sunxi_clk_init(void)
 	return;
 }
 
+const sunxi_clk_plan_t *sunxi_clk_get_plan(void)
+{
+	return &clk_plan;
+}
+
 uint32_t sunxi_clk_get_peri1x_rate()
 {
 	uint32_t reg32;
@@ -42,6 +42,7 @@ void udelay(uint64_t us)
 
 	now = time_us();
 	while (time_us() - now < us) {
+		log_poll();
 	};
 }
 
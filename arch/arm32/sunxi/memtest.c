@@ -0,0 +1,262 @@
+#include <arm_neon.h>
+#include "memtest.h"
+#include "sunxi_wdg.h"
+#include "debug.h"
+
+/*
+ * DRAM test patterns written and checked 64 bytes at a time with NEON
+ * loads and stores, a mismatching block is then rescanned per word.
+ */
+
+#define BLOCK_WORDS		16
+#define WALK_WORDS		1024 // 4KB per walking bit
+#define MAX_REPORTS		8	 // errors printed, all are counted
+#define WDG_TIMEOUT		10	 // seconds, fed every MB
+#define MB_WORDS		(1024 * 1024 / 4)
+
+typedef struct {
+	uint32x4_t q[4];
+} block_t;
+
+static memtest_result_t *result;
+
+static inline void feed_wdg(const uint32_t *p)
+{
+	if (((uint32_t)p & (MB(1) - 1)) == 0)
+		sunxi_wdg_set(WDG_TIMEOUT);
+}
+
+static inline void block_write(uint32_t *p, const block_t *b)
+{
+	vst1q_u32(p, b->q[0]);
+	vst1q_u32(p + 4, b->q[1]);
+	vst1q_u32(p + 8, b->q[2]);
+	vst1q_u32(p + 12, b->q[3]);
+}
+
+static inline bool block_matches(const uint32_t *p, const block_t *b)
+{
+	uint32x4_t diff;
+	uint32x2_t fold;
+
+	diff = veorq_u32(vld1q_u32(p), b->q[0]);
+	diff = vorrq_u32(diff, veorq_u32(vld1q_u32(p + 4), b->q[1]));
+	diff = vorrq_u32(diff, veorq_u32(vld1q_u32(p + 8), b->q[2]));
+	diff = vorrq_u32(diff, veorq_u32(vld1q_u32(p + 12), b->q[3]));
+	fold = vorr_u32(vget_low_u32(diff), vget_high_u32(diff));
+
+	return (vget_lane_u32(fold, 0) | vget_lane_u32(fold, 1)) == 0;
+}
+
+static void block_report(const volatile uint32_t *p, const block_t *b)
+{
+	uint32_t	 expected[BLOCK_WORDS];
+	uint32_t	 actual;
+	unsigned int i;
+
+	block_write(expected, b);
+
+	for (i = 0; i < BLOCK_WORDS; i++) {
+		actual = p[i];
+		if (actual == expected[i])
+			continue;
+
+		if (result->errors == 0) {
+			result->first_addr	   = (uint32_t)&p[i];
+			result->first_expected = expected[i];
+			result->first_actual   = actual;
+		}
+		if (result->errors < MAX_REPORTS)
+			error("MEMTEST: 0x%08" PRIx32 ": 0x%08" PRIx32 " != 0x%08" PRIx32 "\r\n", (uint32_t)&p[i], actual,
+				  expected[i]);
+		result->errors++;
+	}
+}
+
+static inline void block_verify(const uint32_t *p, const block_t *b)
+{
+	if (!block_matches(p, b))
+		block_report(p, b);
+}
+
+static inline void block_fill(block_t *b, uint32_t value)
+{
+	b->q[0] = b->q[1] = b->q[2] = b->q[3] = vdupq_n_u32(value);
+}
+
+static void memtest_walking(uint32_t *start, uint32_t *end)
+{
+	block_t		 b;
+	uint32_t	*p;
+	unsigned int bit;
+
+	if (end > start + WALK_WORDS)
+		end = start + WALK_WORDS;
+
+	for (bit = 0; bit < 64; bit++) {
+		block_fill(&b, bit < 32 ? (1U << bit) : ~(1U << (bit - 32)));
+		for (p = start; p < end; p += BLOCK_WORDS)
+			block_write(p, &b);
+		for (p = start; p < end; p += BLOCK_WORDS)
+			block_verify(p, &b);
+	}
+}
+
+static void address_first(block_t *b, uint32_t *start)
+{
+	static const uint32_t lanes[4] = {0, 4, 8, 12};
+	uint32x4_t			  addr	   = vaddq_u32(vdupq_n_u32((uint32_t)start), vld1q_u32(lanes));
+
+	b->q[0] = addr;
+	b->q[1] = vaddq_u32(addr, vdupq_n_u32(16));
+	b->q[2] = vaddq_u32(addr, vdupq_n_u32(32));
+	b->q[3] = vaddq_u32(addr, vdupq_n_u32(48));
+}
+
+static inline void address_next(block_t *b)
+{
+	uint32x4_t step = vdupq_n_u32(BLOCK_WORDS * 4);
+
+	b->q[0] = vaddq_u32(b->q[0], step);
+	b->q[1] = vaddq_u32(b->q[1], step);
+	b->q[2] = vaddq_u32(b->q[2], step);
+	b->q[3] = vaddq_u32(b->q[3], step);
+}
+
+static void memtest_address(uint32_t *start, uint32_t *end)
+{
+	block_t	  b;
+	uint32_t *p;
+
+	address_first(&b, start);
+	for (p = start; p < end; p += BLOCK_WORDS, address_next(&b)) {
+		feed_wdg(p);
+		block_write(p, &b);
+	}
+
+	address_first(&b, start);
+	for (p = start; p < end; p += BLOCK_WORDS, address_next(&b)) {
+		feed_wdg(p);
+		block_verify(p, &b);
+	}
+}
+
+static void memtest_inversion(uint32_t *start, uint32_t *end)
+{
+	static const uint32_t patterns[] = {0x00000000, 0x55555555};
+	block_t				  b, inv;
+	uint32_t			 *p;
+	unsigned int		  i;
+
+	for (i = 0; i < ARRAY_SIZE(patterns); i++) {
+		block_fill(&b, patterns[i]);
+		block_fill(&inv, ~patterns[i]);
+
+		for (p = start; p < end; p += BLOCK_WORDS) {
+			feed_wdg(p);
+			block_write(p, &b);
+		}
+		for (p = start; p < end; p += BLOCK_WORDS) {
+			feed_wdg(p);
+			block_verify(p, &b);
+			block_write(p, &inv);
+		}
+		for (p = end; p > start;) {
+			p -= BLOCK_WORDS;
+			feed_wdg(p);
+			block_verify(p, &inv);
+			block_write(p, &b);
+		}
+		for (p = start; p < end; p += BLOCK_WORDS) {
+			feed_wdg(p);
+			block_verify(p, &b);
+		}
+	}
+}
+
+static inline uint32x4_t xorshift(uint32x4_t x)
+{
+	x = veorq_u32(x, vshlq_n_u32(x, 13));
+	x = veorq_u32(x, vshrq_n_u32(x, 17));
+	return veorq_u32(x, vshlq_n_u32(x, 5));
+}
+
+static inline void random_next(block_t *b, uint32x4_t *state)
+{
+	b->q[0] = *state = xorshift(*state);
+	b->q[1] = *state = xorshift(*state);
+	b->q[2] = *state = xorshift(*state);
+	b->q[3] = *state = xorshift(*state);
+}
+
+static void memtest_random(uint32_t *start, uint32_t *end)
+{
+	static const uint32_t lanes[4] = {0x2545f491, 0x9e3779b9, 0x6a09e667, 0xbb67ae85};
+	uint32x4_t			  seed, state;
+	block_t				  b;
+	uint32_t			 *p;
+
+	// A new sequence on every run, no lane may start at zero
+	seed = veorq_u32(vld1q_u32(lanes), vdupq_n_u32((uint32_t)time_us()));
+	seed = vorrq_u32(seed, vdupq_n_u32(1));
+
+	state = seed;
+	for (p = start; p < end; p += BLOCK_WORDS) {
+		feed_wdg(p);
+		random_next(&b, &state);
+		block_write(p, &b);
+	}
+
+	state = seed;
+	for (p = start; p < end; p += BLOCK_WORDS) {
+		feed_wdg(p);
+		random_next(&b, &state);
+		block_verify(p, &b);
+	}
+}
+
+static const struct {
+	uint32_t	mode;
+	const char *name;
+	void (*run)(uint32_t *start, uint32_t *end);
+} memtests[] = {
+	{MEMTEST_WALKING, "walking bits", memtest_walking},
+	{MEMTEST_ADDRESS, "address", memtest_address},
+	{MEMTEST_INVERSION, "moving inversions", memtest_inversion},
+	{MEMTEST_RANDOM, "random", memtest_random},
+};
+
+/* Run the selected modes over size_mb from base, the content is lost */
+uint32_t memtest_run(uint32_t base, uint32_t size_mb, uint32_t modes, memtest_result_t *res)
+{
+	uint32_t	*start = (uint32_t *)base;
+	uint32_t	*end   = start + size_mb * MB_WORDS;
+	uint32_t	 begin, errors;
+	unsigned int i;
+
+	memset(res, 0, sizeof(memtest_result_t));
+	res->modes	 = modes;
+	res->size_mb = size_mb;
+	result		 = res;
+
+	info("MEMTEST: %" PRIu32 "MB at 0x%08" PRIx32 "\r\n", size_mb, base);
+	begin = time_ms();
+
+	for (i = 0; i < ARRAY_SIZE(memtests) && size_mb; i++) {
+		if (!(modes & memtests[i].mode))
+			continue;
+
+		errors = res->errors;
+		memtests[i].run(start, end);
+		debug("MEMTEST: %s, %" PRIu32 " errors, %" PRIu32 "ms\r\n", memtests[i].name, res->errors - errors,
+			  time_ms() - begin);
+	}
+
+	res->time_ms = time_ms() - begin;
+	if (res->errors)
+		error("MEMTEST: FAILED, %" PRIu32 " errors in %" PRIu32 "ms\r\n", res->errors, res->time_ms);
+	else
+		info("MEMTEST: OK in %" PRIu32 "ms\r\n", res->time_ms);
+
+	return res->errors;
+}
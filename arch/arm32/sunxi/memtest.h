@@ -0,0 +1,25 @@
+#ifndef __MEMTEST_H__
+#define __MEMTEST_H__
+
+#include "common.h"
+
+// Test modes, they run in this order
+#define MEMTEST_WALKING	  BIT(0) // walking ones and zeros over the data lines
+#define MEMTEST_ADDRESS	  BIT(1) // each word holds its own address
+#define MEMTEST_INVERSION BIT(2) // moving inversions, up then down
+#define MEMTEST_RANDOM	  BIT(3) // xorshift sequence
+#define MEMTEST_ALL		  (MEMTEST_WALKING | MEMTEST_ADDRESS | MEMTEST_INVERSION | MEMTEST_RANDOM)
+
+typedef struct {
+	uint32_t modes;
+	uint32_t size_mb;
+	uint32_t errors;
+	uint32_t first_addr; // first failing word
+	uint32_t first_expected;
+	uint32_t first_actual;
+	uint32_t time_ms;
+} memtest_result_t;
+
+uint32_t memtest_run(uint32_t base, uint32_t size_mb, uint32_t modes, memtest_result_t *result);
+
+#endif
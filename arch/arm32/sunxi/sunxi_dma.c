@@ -25,7 +25,7 @@
 #include <common.h>
 #include "sunxi_dma.h"
 #include "debug.h"
-#include "reg-ccu.h"
+#include "soc.h"
 #include "board.h"
 #include "io.h"
 
@@ -34,25 +34,32 @@
 static int			dma_int_cnt = 0;
 static int			dma_init_ok = -1;
 static dma_source_t dma_channel_source[SUNXI_DMA_MAX];
-static dma_desc_t	dma_channel_desc[SUNXI_DMA_MAX] __attribute__((aligned(64)));
+static dma_desc_t	dma_channel_desc[SUNXI_DMA_MAX][DMA_CHAIN_MAX_DESC] __attribute__((aligned(64)));
 
 void dma_init(void)
 {
 	debug("DMA: init\r\n");
 	int				 i;
-	dma_reg_t *const dma_reg = (dma_reg_t *)SUNXI_DMA_BASE;
+	uint32_t		 val;
+	dma_reg_t *const dma_reg = (dma_reg_t *)sunxi_soc.dma_base;
 
 	if (dma_init_ok > 0)
 		return;
 
 	/* dma : mbus clock gating */
-	ccu->mbus_gate |= 1 << 0;
+	val = read32(sunxi_soc.ccu_base + sunxi_soc.ccu_mbus_gate);
+	val |= 1 << 0;
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_mbus_gate, val);
 
 	/* dma reset */
-	ccu->dma_gate_reset |= 1 << DMA_RST_OFS;
+	val = read32(sunxi_soc.ccu_base + sunxi_soc.ccu_dma_bgr);
+	val |= 1 << DMA_RST_OFS;
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_dma_bgr, val);
 
 	/* dma gating */
-	ccu->dma_gate_reset |= 1 << DMA_GATING_OFS;
+	val = read32(sunxi_soc.ccu_base + sunxi_soc.ccu_dma_bgr);
+	val |= 1 << DMA_GATING_OFS;
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_dma_bgr, val);
 
 	dma_reg->irq_en0 = 0;
 	dma_reg->irq_en1 = 0;
@@ -69,7 +76,7 @@ void dma_init(void)
 	for (i = 0; i < SUNXI_DMA_MAX; i++) {
 		dma_channel_source[i].used	  = 0;
 		dma_channel_source[i].channel = &(dma_reg->channel[i]);
-		dma_channel_source[i].desc	  = &dma_channel_desc[i];
+		dma_channel_source[i].desc	  = dma_channel_desc[i];
 	}
 
 	dma_int_cnt = 0;
@@ -81,7 +88,7 @@ void dma_init(void)
 void dma_exit(void)
 {
 	int		   i;
-	dma_reg_t *dma_reg = (dma_reg_t *)SUNXI_DMA_BASE;
+	dma_reg_t *dma_reg = (dma_reg_t *)sunxi_soc.dma_base;
 #if defined(CONFIG_SUNXI_VERSION1)
 	struct sunxi_ccu_reg *const ccu = (struct sunxi_ccu_reg *)T113_CCU_BASE;
 #endif
@@ -146,7 +153,10 @@ int dma_release(u32 hdma)
 	if (!dma_source->used)
 		return -1;
 
-	dma_source->used = 0;
+	dma_source->used			  = 0;
+	dma_source->busy			  = 0;
+	dma_source->dma_func.m_func = NULL;
+	dma_source->dma_func.m_data = NULL;
 
 	return 0;
 }
@@ -156,47 +166,92 @@ int dma_setting(u32 hdma, dma_set_t *cfg)
 	u32			  commit_para;
 	dma_set_t	  *dma_set	   = cfg;
 	dma_source_t *dma_source   = (dma_source_t *)hdma;
-	dma_desc_t   *desc		   = dma_source->desc;
 	u32			  channel_addr = (u32)(&(dma_set->channel_cfg));
 
 	if (!dma_source->used)
 		return -1;
 
-	if (dma_set->loop_mode)
-		desc->link = (u32)(&dma_source->desc);
-	else
-		desc->link = SUNXI_DMA_LINK_NULL;
-
 	commit_para = (dma_set->wait_cyc & 0xff);
 	commit_para |= (dma_set->data_block_size & 0xff) << 8;
 
-	desc->commit_para = commit_para;
-	desc->config	  = *(volatile u32 *)channel_addr;
+	dma_source->loop_mode	= dma_set->loop_mode;
+	dma_source->commit_para = commit_para;
+	dma_source->config		= *(volatile u32 *)channel_addr;
 
 	return 0;
 }
 
-int dma_start(u32 hdma, u32 saddr, u32 daddr, u32 bytes)
+/*
+ * Program the channel with a linked list of descriptors, one per segment.
+ * The controller walks the chain on its own, the CPU is free until dma_poll()/dma_wait().
+ */
+int dma_start_sg(u32 hdma, const dma_sg_t *sg, u32 count)
 {
 	dma_source_t		 *dma_source = (dma_source_t *)hdma;
 	dma_channel_reg_t *channel	  = dma_source->channel;
 	dma_desc_t		   *desc		  = dma_source->desc;
+	u32				   i;
 
-	if (!dma_source->used)
+	if (!dma_source->used || !count || count > DMA_CHAIN_MAX_DESC)
 		return -1;
 
-	/*config desc */
-	desc->source_addr = saddr;
-	desc->dest_addr	  = daddr;
-	desc->byte_count  = bytes;
+	for (i = 0; i < count; i++) {
+		desc[i].config		= dma_source->config;
+		desc[i].commit_para = dma_source->commit_para;
+		desc[i].source_addr = sg[i].saddr;
+		desc[i].dest_addr	= sg[i].daddr;
+		desc[i].byte_count	= sg[i].bytes;
+		desc[i].link		= (u32)&desc[i + 1];
+	}
+	desc[count - 1].link = dma_source->loop_mode ? (u32)&desc[0] : SUNXI_DMA_LINK_NULL;
 
 	/* start dma */
+	dma_source->busy   = 1;
 	channel->desc_addr = (u32)desc;
 	channel->enable	   = 1;
 
 	return 0;
 }
 
+/*
+ * Contiguous transfer, split in DMA_DESC_MAX_BYTES segments chained in one program
+ */
+int dma_start(u32 hdma, u32 saddr, u32 daddr, u32 bytes)
+{
+	dma_source_t *dma_source = (dma_source_t *)hdma;
+	dma_sg_t	  sg[DMA_CHAIN_MAX_DESC];
+	u32			  count = 0;
+	u32			  n;
+	u32			  src_io, dst_io;
+
+	if (!dma_source->used)
+		return -1;
+
+	/* IO mode addresses (FIFOs) do not advance */
+	src_io = (dma_source->config >> 8) & 0x1;
+	dst_io = (dma_source->config >> 24) & 0x1;
+
+	do {
+		if (count == DMA_CHAIN_MAX_DESC) {
+			error("DMA: transfer of %" PRIu32 " bytes is too large\r\n", bytes);
+			return -1;
+		}
+		n				  = min(bytes, DMA_DESC_MAX_BYTES);
+		sg[count].saddr = saddr;
+		sg[count].daddr = daddr;
+		sg[count].bytes = n;
+		count++;
+
+		if (!src_io)
+			saddr += n;
+		if (!dst_io)
+			daddr += n;
+		bytes -= n;
+	} while (bytes);
+
+	return dma_start_sg(hdma, sg, count);
+}
+
 int dma_stop(u32 hdma)
 {
 	dma_source_t		 *dma_source = (dma_source_t *)hdma;
@@ -204,7 +259,8 @@ int dma_stop(u32 hdma)
 
 	if (!dma_source->used)
 		return -1;
-	channel->enable = 0;
+	channel->enable	 = 0;
+	dma_source->busy = 0;
 
 	return 0;
 }
@@ -213,7 +269,7 @@ int dma_querystatus(u32 hdma)
 {
 	u32			  channel_count;
 	dma_source_t *dma_source = (dma_source_t *)hdma;
-	dma_reg_t	  *dma_reg	 = (dma_reg_t *)SUNXI_DMA_BASE;
+	dma_reg_t	  *dma_reg	 = (dma_reg_t *)sunxi_soc.dma_base;
 
 	if (!dma_source->used)
 		return -1;
@@ -223,6 +279,58 @@ int dma_querystatus(u32 hdma)
 	return (dma_reg->status >> channel_count) & 0x01;
 }
 
+int dma_set_callback(u32 hdma, void (*func)(void *data), void *data)
+{
+	dma_source_t *dma_source = (dma_source_t *)hdma;
+
+	if (!dma_source->used)
+		return -1;
+
+	dma_source->dma_func.m_func = func;
+	dma_source->dma_func.m_data = data;
+
+	return 0;
+}
+
+/*
+ * Returns 1 while the channel is running.
+ * Interrupts stay masked in the bootloader, so completion is reported from here:
+ * the callback runs once, from the first poll that sees the channel idle.
+ */
+int dma_poll(u32 hdma)
+{
+	dma_source_t *dma_source = (dma_source_t *)hdma;
+	int			  st;
+
+	st = dma_querystatus(hdma);
+	if (st != 0)
+		return st;
+
+	if (dma_source->busy) {
+		dma_source->busy = 0;
+		if (dma_source->dma_func.m_func)
+			dma_source->dma_func.m_func(dma_source->dma_func.m_data);
+	}
+
+	return 0;
+}
+
+int dma_wait(u32 hdma, u32 timeout_ms)
+{
+	u32 start = time_ms();
+	int st;
+
+	while ((st = dma_poll(hdma)) > 0) {
+		if (timeout_ms && (time_ms() - start) > timeout_ms) {
+			error("DMA: wait timeout\r\n");
+			dma_stop(hdma);
+			return -1;
+		}
+	}
+
+	return st;
+}
+
 int dma_test()
 {
 	u32		*src_addr = (u32 *)CONFIG_DTB_LOAD_ADDR;
@@ -273,10 +381,10 @@ int dma_test()
 	timeout = time_ms();
 
 	dma_start(hdma, (u32)src_addr, (u32)dst_addr, len);
-	st = dma_querystatus(hdma);
+	st = dma_poll(hdma);
 
 	while ((time_ms() - timeout < 100) && st) {
-		st = dma_querystatus(hdma);
+		st = dma_poll(hdma);
 	}
 
 	if (st) {
@@ -305,3 +413,111 @@ int dma_test()
 
 	return 0;
 }
+
+static u32 dma_mem_drq_type(u32 addr)
+{
+	return addr >= SDRAM_BASE ? DMAC_CFG_TYPE_DRAM : DMAC_CFG_TYPE_SRAM;
+}
+
+/*
+ * Start a memory to memory copy and return the channel handle, 0 on failure.
+ * The CPU is free until dma_memcpy_wait(), which also releases the channel.
+ */
+u32 dma_memcpy_async(void *dst, const void *src, u32 len)
+{
+	dma_set_t dma_set;
+	u32		  hdma, width;
+
+	if (dma_init_ok <= 0 || !len)
+		return 0;
+
+	// Word beats when everything is aligned, bytes otherwise
+	if ((((u32)dst | (u32)src | len) & 0x3) == 0)
+		width = DMAC_CFG_SRC_DATA_WIDTH_32BIT;
+	else
+		width = DMAC_CFG_SRC_DATA_WIDTH_8BIT;
+
+	dma_set.loop_mode		= 0;
+	dma_set.wait_cyc		= 0;
+	dma_set.data_block_size = 1 * 32 / 8;
+
+	dma_set.channel_cfg.src_drq_type	 = dma_mem_drq_type((u32)src);
+	dma_set.channel_cfg.src_addr_mode	 = DMAC_CFG_SRC_ADDR_TYPE_LINEAR_MODE;
+	dma_set.channel_cfg.src_burst_length = DMAC_CFG_SRC_8_BURST;
+	dma_set.channel_cfg.src_data_width	 = width;
+	dma_set.channel_cfg.reserved0		 = 0;
+
+	dma_set.channel_cfg.dst_drq_type	 = dma_mem_drq_type((u32)dst);
+	dma_set.channel_cfg.dst_addr_mode	 = DMAC_CFG_DEST_ADDR_TYPE_LINEAR_MODE;
+	dma_set.channel_cfg.dst_burst_length = DMAC_CFG_DEST_8_BURST;
+	dma_set.channel_cfg.dst_data_width	 = width;
+	dma_set.channel_cfg.reserved1		 = 0;
+
+	// Keep low channels for peripherals
+	hdma = dma_request_from_last(DMAC_DMATYPE_NORMAL);
+	if (!hdma)
+		return 0;
+
+	dma_setting(hdma, &dma_set);
+	if (dma_start(hdma, (u32)src, (u32)dst, len) != 0) {
+		dma_release(hdma);
+		return 0;
+	}
+
+	return hdma;
+}
+
+int dma_memcpy_wait(u32 hdma)
+{
+	int ret;
+
+	ret = dma_wait(hdma, 1000);
+	dma_release(hdma);
+
+	return ret;
+}
+
+/*
+ * Synchronous copy, falls back to the CPU for small sizes or when no channel is available
+ */
+void dma_memcpy(void *dst, const void *src, u32 len)
+{
+	u32 hdma = 0;
+
+	if (len >= DMA_MEMCPY_MIN_SIZE)
+		hdma = dma_memcpy_async(dst, src, len);
+
+	if (!hdma || dma_memcpy_wait(hdma) != 0)
+		memcpy(dst, src, len);
+}
+
+/*
+ * Compare CPU (NEON memcpy) and DMA copy throughput from 4KB to 32MB
+ */
+void dma_memcpy_bench(u32 mem_size)
+{
+	u8 *src = (u8 *)SDRAM_BASE;
+	u8 *dst = (u8 *)SDRAM_BASE + mem_size / 2;
+	u32 len, hdma;
+	u64 start, cpu_time, dma_time;
+
+	info("DMA: memcpy benchmark, size / CPU / DMA\r\n");
+
+	// Stays clear of the DRAM code at the top of the memory
+	for (len = 4 * 1024; len <= 32 * 1024 * 1024 && len < mem_size / 2; len <<= 1) {
+		start = time_us();
+		memcpy(dst, src, len);
+		cpu_time = time_us() - start + 1;
+
+		start = time_us();
+		hdma  = dma_memcpy_async(dst, src, len);
+		if (!hdma || dma_memcpy_wait(hdma) != 0) {
+			error("DMA: benchmark copy failed\r\n");
+			return;
+		}
+		dma_time = time_us() - start + 1;
+
+		info("DMA: %6" PRIu32 "KB %8" PRIu32 "KB/s %8" PRIu32 "KB/s\r\n", len / 1024,
+			 (u32)(((u64)len * 1000000 / cpu_time) / 1024), (u32)(((u64)len * 1000000 / dma_time) / 1024));
+	}
+}
@@ -8,10 +8,6 @@
 #ifndef _SUNXI_DMA_H
 #define _SUNXI_DMA_H
 
-#define SUNXI_DMA_BASE		   0x03002000
-#define SUNXI_DMA_CHANNEL_BASE (SUNXI_DMA_BASE + 0x100)
-#define DMA_AUTO_GATE_REG	   (SUNXI_DMA_BASE + 0x28)
-
 #define SUNXI_DMA_CHANNEL_SIZE (0x40)
 #define SUNXI_DMA_LINK_NULL	   (0xfffff800)
 
@@ -94,8 +90,7 @@ typedef struct {
 
 typedef struct {
 	void *m_data;
-	// void (*m_func)(void *data);
-	void (*m_func)(void);
+	void (*m_func)(void *data);
 } dma_irq_handler_t;
 
 typedef struct {
@@ -131,18 +126,35 @@ typedef struct {
 	dma_channel_reg_t channel[16]; /* 0x100 dma channel register */
 } dma_reg_t;
 
+/* One segment of a chained transfer */
+typedef struct {
+	u32 saddr;
+	u32 daddr;
+	u32 bytes;
+} dma_sg_t;
+
 typedef struct {
 	u32				   used;
 	u32				   channel_count;
 	dma_channel_reg_t *channel;
-	u32				   reserved;
-	dma_desc_t		   *desc;
+	u32				   busy; // started and completion not reported yet
+	dma_desc_t		   *desc; // DMA_CHAIN_MAX_DESC descriptors
 	dma_irq_handler_t  dma_func;
+	u32				   config;
+	u32				   commit_para;
+	u32				   loop_mode;
 } dma_source_t;
 
 #define DMA_RST_OFS	   16
 #define DMA_GATING_OFS 0
 
+/* Descriptors per channel, and bytes per descriptor (BCNT is 25 bits) */
+#define DMA_CHAIN_MAX_DESC 4
+#define DMA_DESC_MAX_BYTES (16 * 1024 * 1024)
+
+/* Below this size the setup cost outweighs the gain, dma_memcpy() uses the CPU */
+#define DMA_MEMCPY_MIN_SIZE (4 * 1024)
+
 void dma_init(void);
 void dma_exit(void);
 
@@ -151,9 +163,18 @@ u32 dma_request_from_last(u32 dmatype);
 int dma_release(u32 hdma);
 int dma_setting(u32 hdma, dma_set_t *cfg);
 int dma_start(u32 hdma, u32 saddr, u32 daddr, u32 bytes);
+int dma_start_sg(u32 hdma, const dma_sg_t *sg, u32 count);
 int dma_stop(u32 hdma);
 int dma_querystatus(u32 hdma);
+int dma_set_callback(u32 hdma, void (*func)(void *data), void *data);
+int dma_poll(u32 hdma);
+int dma_wait(u32 hdma, u32 timeout_ms);
 
 int dma_test();
 
+u32	 dma_memcpy_async(void *dst, const void *src, u32 len);
+int	 dma_memcpy_wait(u32 hdma);
+void dma_memcpy(void *dst, const void *src, u32 len);
+void dma_memcpy_bench(u32 mem_size);
+
 #endif /* _SUNXI_DMA_H */
@@ -1,6 +1,7 @@
 #include "common.h"
 #include "debug.h"
 #include "sunxi_gpio.h"
+#include "soc.h"
 
 enum {
 	GPIO_CFG0 = 0x00,
@@ -23,30 +24,12 @@ static inline uint32_t _port_num(gpio_t pin)
 
 static uint32_t _port_base_get(gpio_t pin)
 {
-	uint32_t port = pin >> PIO_NUM_IO_BITS;
+	uint32_t port = _port_num(pin);
 
-	switch (port) {
-		case PORTB:
-			return 0x02000030;
-			break;
-		case PORTC:
-			return 0x02000060;
-			break;
-		case PORTD:
-			return 0x02000090;
-			break;
-		case PORTE:
-			return 0x020000c0;
-			break;
-		case PORTF:
-			return 0x020000f0;
-			break;
-		case PORTG:
-			return 0x02000120;
-			break;
-	}
+	if (port > PORTH || !(sunxi_soc.gpio_ports & BIT(port)))
+		return 0;
 
-	return 0;
+	return sunxi_soc.gpio_base + port * 0x30;
 }
 
 static inline uint32_t _pin_num(gpio_t pin)
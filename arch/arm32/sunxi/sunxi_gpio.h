@@ -17,13 +17,15 @@ enum {
 	GPIO_DISABLED	  = 0xf,
 };
 
-#define PORTB			 0
-#define PORTC			 1
-#define PORTD			 2
-#define PORTE			 3
-#define PORTF			 4
-#define PORTG			 5
-#define SUNXI_GPIO_PORTS (PORTG + 1)
+// Port letter index, the ports a SoC has are listed in sunxi_soc.gpio_ports
+#define PORTA 0
+#define PORTB 1
+#define PORTC 2
+#define PORTD 3
+#define PORTE 4
+#define PORTF 5
+#define PORTG 6
+#define PORTH 7
 
 enum gpio_pull_t {
 	GPIO_PULL_UP   = 0,
@@ -33,10 +33,17 @@
 #include "sunxi_sdhci.h"
 #include "sunxi_gpio.h"
 #include "sunxi_clk.h"
+#include "soc.h"
 
 #define FALSE 0
 #define TRUE  1
 
+/*
+ * Register accesses go through io.h, so host builds can script the controller
+ */
+#define smhc_read(sdhci, r)		read32((virtual_addr_t)&(sdhci)->reg->r)
+#define smhc_write(sdhci, r, v) write32((virtual_addr_t)&(sdhci)->reg->r, (v))
+
 /*
  * Global control register bits
  */
@@ -224,14 +231,14 @@ static void set_read_timeout(sdhci_t *sdhci, u32 timeout)
 	u32 mode_2x	 = 0;
 
 	rdto_clk = sdhci->clock / 1000 * timeout;
-	rval	 = sdhci->reg->ntsr;
+	rval	 = smhc_read(sdhci, ntsr);
 	mode_2x	 = rval & (0x1 << 31);
 
 	if ((sdhci->clock == MMC_CLK_50M_DDR && mode_2x)) {
 		rdto_clk = rdto_clk << 1;
 	}
 
-	rval = sdhci->reg->gctrl;
+	rval = smhc_read(sdhci, gctrl);
 	/*ddr50 mode don't use 256x timeout unit*/
 	if (rdto_clk > 0xffffff && sdhci->clock == MMC_CLK_50M_DDR) {
 		rdto_clk = (rdto_clk + 255) / 256;
@@ -240,15 +247,15 @@ static void set_read_timeout(sdhci_t *sdhci, u32 timeout)
 		rdto_clk = 0xffffff;
 		rval &= ~(0x1 << 11);
 	}
-	sdhci->reg->gctrl = rval;
+	smhc_write(sdhci, gctrl, rval);
 
-	rval = sdhci->reg->timeout;
+	rval = smhc_read(sdhci, timeout);
 	rval &= ~(0xffffff << 8);
 	rval |= (rdto_clk << 8);
-	sdhci->reg->timeout = rval;
+	smhc_write(sdhci, timeout, rval);
 
-	trace("rdtoclk:%" PRIu32 ", reg-tmout:%" PRIu32 ", gctl:%" PRIx32 ", clock:%u, nstr:%" PRIx32 "\n", rdto_clk, sdhci->reg->timeout, sdhci->reg->gctrl,
-		  sdhci->clock, sdhci->reg->ntsr);
+	trace("rdtoclk:%" PRIu32 ", reg-tmout:%" PRIu32 ", gctl:%" PRIx32 ", clock:%u, nstr:%" PRIx32 "\n", rdto_clk, smhc_read(sdhci, timeout), smhc_read(sdhci, gctrl),
+		  sdhci->clock, smhc_read(sdhci, ntsr));
 }
 
 static int prepare_dma(sdhci_t *sdhci, sdhci_data_t *data)
@@ -311,21 +318,21 @@ static int prepare_dma(sdhci_t *sdhci, sdhci_data_t *data)
 	 * IDIE[0]	: IDMA transmit interrupt flag
 	 * IDIE[1]	: IDMA receive interrupt flag
 	 */
-	sdhci->reg->idst = 0x337; // clear interrupt status
-	sdhci->reg->gctrl |= SMHC_GCTRL_DMA_ENABLE | SMHC_GCTRL_DMA_RESET; /* dma enable */
-	sdhci->reg->dmac = SMHC_IDMAC_SOFT_RESET; /* idma reset */
-	while (sdhci->reg->dmac & SMHC_IDMAC_SOFT_RESET) {
+	smhc_write(sdhci, idst, 0x337); // clear interrupt status
+	smhc_write(sdhci, gctrl, smhc_read(sdhci, gctrl) | SMHC_GCTRL_DMA_ENABLE | SMHC_GCTRL_DMA_RESET); /* dma enable */
+	smhc_write(sdhci, dmac, SMHC_IDMAC_SOFT_RESET); /* idma reset */
+	while (smhc_read(sdhci, dmac) & SMHC_IDMAC_SOFT_RESET) {
 	} /* wait idma reset done */
 
-	sdhci->reg->dmac = SMHC_IDMAC_FIX_BURST | SMHC_IDMAC_IDMA_ON; /* idma on */
-	sdhci->reg->idie &= ~(SMHC_IDMAC_TRANSMIT_INTERRUPT | SMHC_IDMAC_RECEIVE_INTERRUPT);
+	smhc_write(sdhci, dmac, SMHC_IDMAC_FIX_BURST | SMHC_IDMAC_IDMA_ON); /* idma on */
+	smhc_write(sdhci, idie, smhc_read(sdhci, idie) & ~(SMHC_IDMAC_TRANSMIT_INTERRUPT | SMHC_IDMAC_RECEIVE_INTERRUPT));
 	if (data->flag & MMC_DATA_WRITE)
-		sdhci->reg->idie |= SMHC_IDMAC_TRANSMIT_INTERRUPT;
+		smhc_write(sdhci, idie, smhc_read(sdhci, idie) | SMHC_IDMAC_TRANSMIT_INTERRUPT);
 	else
-		sdhci->reg->idie |= SMHC_IDMAC_RECEIVE_INTERRUPT;
+		smhc_write(sdhci, idie, smhc_read(sdhci, idie) | SMHC_IDMAC_RECEIVE_INTERRUPT);
 
-	sdhci->reg->dlba	  = (u32)pdes >> 2;
-	sdhci->reg->ftrglevel = sdhci->dma_trglvl;
+	smhc_write(sdhci, dlba, (u32)pdes >> 2);
+	smhc_write(sdhci, ftrglevel, sdhci->dma_trglvl);
 
 	return 0;
 }
@@ -337,7 +344,7 @@ static int wait_done(sdhci_t *sdhci, sdhci_data_t *dat, u32 timeout_msecs, u32 f
 	u32 start = time_ms();
 	trace("SMHC: wait for flag 0x%" PRIx32 "\r\n", flag);
 	do {
-		status = sdhci->reg->rint;
+		status = smhc_read(sdhci, rint);
 		if ((time_ms() > (start + timeout_msecs))) {
 			warning("SMHC: wait timeout %" PRIx32 " status %" PRIx32 " flag %" PRIx32 "\r\n", status & SMHC_RINT_INTERRUPT_ERROR_BIT, status,
 					flag);
@@ -348,7 +355,7 @@ static int wait_done(sdhci_t *sdhci, sdhci_data_t *dat, u32 timeout_msecs, u32 f
 			return -1;
 		}
 		if (dat && dma && (dat->blkcnt * dat->blksz) > 0)
-			done = ((status & flag) && (sdhci->reg->idst & SMHC_IDMAC_RECEIVE_INTERRUPT)) ? 1 : 0;
+			done = ((status & flag) && (smhc_read(sdhci, idst) & SMHC_IDMAC_RECEIVE_INTERRUPT)) ? 1 : 0;
 		else
 			done = (status & flag);
 	} while (!done);
@@ -369,13 +376,13 @@ static bool read_bytes(sdhci_t *sdhci, sdhci_data_t *dat)
 
 	trace("SMHC: read %" PRIu32 "\r\n", count);
 
-	status = sdhci->reg->status;
-	err	   = sdhci->reg->rint & SMHC_RINT_INTERRUPT_ERROR_BIT;
+	status = smhc_read(sdhci, status);
+	err	   = smhc_read(sdhci, rint) & SMHC_RINT_INTERRUPT_ERROR_BIT;
 	if (err)
 		warning("SMHC: interrupt error 0x%" PRIx32 " status 0x%" PRIx32 "\r\n", err & SMHC_RINT_INTERRUPT_ERROR_BIT, status);
 
 	while ((!err) && (count >= sizeof(sdhci->reg->fifo))) {
-		while (sdhci->reg->status & SMHC_STATUS_FIFO_EMPTY) {
+		while (smhc_read(sdhci, status) & SMHC_STATUS_FIFO_EMPTY) {
 			if (time_ms() > timeout) {
 				warning("SMHC: read timeout\r\n");
 				return FALSE;
@@ -384,15 +391,15 @@ static bool read_bytes(sdhci_t *sdhci, sdhci_data_t *dat)
 		in_fifo = SMHC_STATUS_FIFO_LEVEL(status);
 		count -= sizeof(sdhci->reg->fifo) * in_fifo;
 		while (in_fifo--) {
-			*(tmp++) = sdhci->reg->fifo;
+			*(tmp++) = smhc_read(sdhci, fifo);
 		}
 
-		status = sdhci->reg->status;
-		err	   = sdhci->reg->rint & SMHC_RINT_INTERRUPT_ERROR_BIT;
+		status = smhc_read(sdhci, status);
+		err	   = smhc_read(sdhci, rint) & SMHC_RINT_INTERRUPT_ERROR_BIT;
 	}
 
 	do {
-		status = sdhci->reg->rint;
+		status = smhc_read(sdhci, rint);
 
 		err = status & SMHC_RINT_INTERRUPT_ERROR_BIT;
 		if (dat->blkcnt > 1)
@@ -426,24 +433,24 @@ static bool write_bytes(sdhci_t *sdhci, sdhci_data_t *dat)
 
 	trace("SMHC: write %llu\r\n", count);
 
-	status = sdhci->reg->status;
-	err	   = sdhci->reg->rint & SMHC_RINT_INTERRUPT_ERROR_BIT;
+	status = smhc_read(sdhci, status);
+	err	   = smhc_read(sdhci, rint) & SMHC_RINT_INTERRUPT_ERROR_BIT;
 	while (!err && count) {
-		while (sdhci->reg->status & SMHC_STATUS_FIFO_FULL) {
+		while (smhc_read(sdhci, status) & SMHC_STATUS_FIFO_FULL) {
 			if (time_ms() > timeout) {
 				warning("SMHC: write timeout\r\n");
 				return FALSE;
 			}
 		}
-		sdhci->reg->fifo = *(tmp++);
+		smhc_write(sdhci, fifo, *(tmp++));
 		count -= sizeof(u32);
 
-		status = sdhci->reg->status;
-		err	   = sdhci->reg->rint & SMHC_RINT_INTERRUPT_ERROR_BIT;
+		status = smhc_read(sdhci, status);
+		err	   = smhc_read(sdhci, rint) & SMHC_RINT_INTERRUPT_ERROR_BIT;
 	}
 
 	do {
-		status = sdhci->reg->rint;
+		status = smhc_read(sdhci, rint);
 		err	   = status & SMHC_RINT_INTERRUPT_ERROR_BIT;
 		if (dat->blkcnt > 1)
 			done = status & SMHC_RINT_AUTO_COMMAND_DONE;
@@ -471,10 +478,10 @@ bool sdhci_transfer(sdhci_t *sdhci, sdhci_cmd_t *cmd, sdhci_data_t *dat)
 	if (cmd->idx == MMC_STOP_TRANSMISSION) {
 		timeout = time_ms();
 		do {
-			status = sdhci->reg->status;
+			status = smhc_read(sdhci, status);
 			if (time_ms() - timeout > 10) {
-				sdhci->reg->gctrl = SMHC_GCTRL_HARDWARE_RESET;
-				sdhci->reg->rint  = 0xffffffff;
+				smhc_write(sdhci, gctrl, SMHC_GCTRL_HARDWARE_RESET);
+				smhc_write(sdhci, rint, 0xffffffff);
 				warning("SMHC: stop timeout\r\n");
 				return FALSE;
 			}
@@ -491,41 +498,41 @@ bool sdhci_transfer(sdhci_t *sdhci, sdhci_cmd_t *cmd, sdhci_data_t *dat)
 	}
 
 	if (dat) {
-		sdhci->reg->blksz	= dat->blksz;
-		sdhci->reg->bytecnt = (u32)(dat->blkcnt * dat->blksz);
+		smhc_write(sdhci, blksz, dat->blksz);
+		smhc_write(sdhci, bytecnt, (u32)(dat->blkcnt * dat->blksz));
 
 		cmdval |= SMHC_CMD_DATA_EXPIRE | SMHC_CMD_WAIT_PRE_OVER;
 		set_read_timeout(sdhci, DTO_MAX);
 
 		if (dat->flag & MMC_DATA_WRITE) {
 			cmdval |= SMHC_CMD_WRITE;
-			sdhci->reg->idst |= SMHC_IDMAC_TRANSMIT_INTERRUPT; // clear TX status
+			smhc_write(sdhci, idst, smhc_read(sdhci, idst) | SMHC_IDMAC_TRANSMIT_INTERRUPT); // clear TX status
 		}
 		if (dat->flag & MMC_DATA_READ)
-			sdhci->reg->idst |= SMHC_IDMAC_RECEIVE_INTERRUPT; // clear RX status
+			smhc_write(sdhci, idst, smhc_read(sdhci, idst) | SMHC_IDMAC_RECEIVE_INTERRUPT); // clear RX status
 	}
 
 	if (cmd->idx == MMC_WRITE_MULTIPLE_BLOCK || cmd->idx == MMC_READ_MULTIPLE_BLOCK)
 		cmdval |= SMHC_CMD_SEND_AUTO_STOP;
 
-	sdhci->reg->rint = 0xffffffff; // Clear status
-	sdhci->reg->arg	 = cmd->arg;
+	smhc_write(sdhci, rint, 0xffffffff); // Clear status
+	smhc_write(sdhci, arg, cmd->arg);
 
 	if (dat && (dat->blkcnt * dat->blksz) > 64) {
 		dma = true;
-		sdhci->reg->gctrl &= ~SMHC_GCTRL_ACCESS_BY_AHB;
+		smhc_write(sdhci, gctrl, smhc_read(sdhci, gctrl) & ~SMHC_GCTRL_ACCESS_BY_AHB);
 		prepare_dma(sdhci, dat);
-		sdhci->reg->cmd = cmdval | cmd->idx | SMHC_CMD_START; // Start
+		smhc_write(sdhci, cmd, cmdval | cmd->idx | SMHC_CMD_START); // Start
 	} else if (dat && (dat->blkcnt * dat->blksz) > 0) {
-		sdhci->reg->gctrl |= SMHC_GCTRL_ACCESS_BY_AHB;
-		sdhci->reg->cmd = cmdval | cmd->idx | SMHC_CMD_START; // Start
+		smhc_write(sdhci, gctrl, smhc_read(sdhci, gctrl) | SMHC_GCTRL_ACCESS_BY_AHB);
+		smhc_write(sdhci, cmd, cmdval | cmd->idx | SMHC_CMD_START); // Start
 		if (dat->flag & MMC_DATA_READ && !read_bytes(sdhci, dat))
 			return FALSE;
 		else if (dat->flag & MMC_DATA_WRITE && !write_bytes(sdhci, dat))
 			return FALSE;
 	} else {
-		sdhci->reg->gctrl |= SMHC_GCTRL_ACCESS_BY_AHB;
-		sdhci->reg->cmd = cmdval | cmd->idx | SMHC_CMD_START; // Start
+		smhc_write(sdhci, gctrl, smhc_read(sdhci, gctrl) | SMHC_GCTRL_ACCESS_BY_AHB);
+		smhc_write(sdhci, cmd, cmdval | cmd->idx | SMHC_CMD_START); // Start
 	}
 
 	if (wait_done(sdhci, 0, 100, SMHC_RINT_COMMAND_DONE, false)) {
@@ -541,10 +548,10 @@ bool sdhci_transfer(sdhci_t *sdhci, sdhci_cmd_t *cmd, sdhci_data_t *dat)
 	if (cmd->resptype & MMC_RSP_BUSY) {
 		timeout = time_ms();
 		do {
-			status = sdhci->reg->status;
+			status = smhc_read(sdhci, status);
 			if (time_ms() - timeout > 10) {
-				sdhci->reg->gctrl = SMHC_GCTRL_HARDWARE_RESET;
-				sdhci->reg->rint  = 0xffffffff;
+				smhc_write(sdhci, gctrl, SMHC_GCTRL_HARDWARE_RESET);
+				smhc_write(sdhci, rint, 0xffffffff);
 				warning("SMHC: busy timeout\r\n");
 				return FALSE;
 			}
@@ -552,21 +559,21 @@ bool sdhci_transfer(sdhci_t *sdhci, sdhci_cmd_t *cmd, sdhci_data_t *dat)
 	}
 
 	if (cmd->resptype & MMC_RSP_136) {
-		cmd->response[0] = sdhci->reg->resp3;
-		cmd->response[1] = sdhci->reg->resp2;
-		cmd->response[2] = sdhci->reg->resp1;
-		cmd->response[3] = sdhci->reg->resp0;
+		cmd->response[0] = smhc_read(sdhci, resp3);
+		cmd->response[1] = smhc_read(sdhci, resp2);
+		cmd->response[2] = smhc_read(sdhci, resp1);
+		cmd->response[3] = smhc_read(sdhci, resp0);
 	} else {
-		cmd->response[0] = sdhci->reg->resp0;
+		cmd->response[0] = smhc_read(sdhci, resp0);
 	}
 
 	// Cleanup and disable IDMA
 	if (dat && dma) {
-		status			 = sdhci->reg->idst;
-		sdhci->reg->idst = status;
-		sdhci->reg->idie = 0;
-		sdhci->reg->dmac = 0;
-		sdhci->reg->gctrl &= ~SMHC_GCTRL_DMA_ENABLE;
+		status = smhc_read(sdhci, idst);
+		smhc_write(sdhci, idst, status);
+		smhc_write(sdhci, idie, 0);
+		smhc_write(sdhci, dmac, 0);
+		smhc_write(sdhci, gctrl, smhc_read(sdhci, gctrl) & ~SMHC_GCTRL_DMA_ENABLE);
 	}
 
 	return TRUE;
@@ -574,20 +581,20 @@ bool sdhci_transfer(sdhci_t *sdhci, sdhci_cmd_t *cmd, sdhci_data_t *dat)
 
 bool sdhci_reset(sdhci_t *sdhci)
 {
-	sdhci->reg->gctrl = SMHC_GCTRL_HARDWARE_RESET;
+	smhc_write(sdhci, gctrl, SMHC_GCTRL_HARDWARE_RESET);
 	return TRUE;
 }
 
 bool sdhci_set_width(sdhci_t *sdhci, u32 width)
 {
 	const char UNUSED_TRACE *mode = "1 bit";
-	sdhci->reg->gctrl &= ~SMHC_GCTRL_DDR_MODE;
+	smhc_write(sdhci, gctrl, smhc_read(sdhci, gctrl) & ~SMHC_GCTRL_DDR_MODE);
 	switch (width) {
 		case MMC_BUS_WIDTH_1:
-			sdhci->reg->width = SMHC_WIDTH_1BIT;
+			smhc_write(sdhci, width, SMHC_WIDTH_1BIT);
 			break;
 		case MMC_BUS_WIDTH_4:
-			sdhci->reg->width = SMHC_WIDTH_4BIT;
+			smhc_write(sdhci, width, SMHC_WIDTH_4BIT);
 			mode			  = "4 bit";
 			break;
 		default:
@@ -595,7 +602,7 @@ bool sdhci_set_width(sdhci_t *sdhci, u32 width)
 			return FALSE;
 	}
 	if (sdhci->clock == MMC_CLK_50M_DDR) {
-		sdhci->reg->gctrl |= SMHC_GCTRL_DDR_MODE;
+		smhc_write(sdhci, gctrl, smhc_read(sdhci, gctrl) | SMHC_GCTRL_DDR_MODE);
 		mode = "4 bit DDR";
 	}
 
@@ -620,7 +627,7 @@ static int init_default_timing(sdhci_t *sdhci)
 
 static int config_delay(sdhci_t *sdhci)
 {
-	u32 rval, freq;
+	u32 rval, freq, clk_cfg;
 	u8	odly, sdly;
 
 	freq = sdhci->clock;
@@ -630,41 +637,44 @@ static int config_delay(sdhci_t *sdhci)
 
 	trace("SMHC: odly: %d   sldy: %d\r\n", odly, sdly);
 
-	ccu->smhc0_clk_cfg &= (~CCU_MMC_CTRL_ENABLE);
-	sdhci->reg->drv_dl &= (~(0x3 << 16));
-	sdhci->reg->drv_dl |= (((odly & 0x1) << 16) | ((odly & 0x1) << 17));
-	ccu->smhc0_clk_cfg |= CCU_MMC_CTRL_ENABLE;
+	clk_cfg = sunxi_soc.ccu_base + sunxi_soc.ccu_smhc0_clk;
+	write32(clk_cfg, read32(clk_cfg) & ~CCU_MMC_CTRL_ENABLE);
+	smhc_write(sdhci, drv_dl, smhc_read(sdhci, drv_dl) & (~(0x3 << 16)));
+	smhc_write(sdhci, drv_dl, smhc_read(sdhci, drv_dl) | (((odly & 0x1) << 16) | ((odly & 0x1) << 17)));
+	write32(clk_cfg, read32(clk_cfg) | CCU_MMC_CTRL_ENABLE);
 
-	rval = sdhci->reg->ntsr;
+	rval = smhc_read(sdhci, ntsr);
 	rval &= (~(0x3 << 8));
 	rval |= ((sdly & 0x3) << 8);
-	sdhci->reg->ntsr = rval;
+	smhc_write(sdhci, ntsr, rval);
 
 	/*enable hw skew auto mode*/
-	rval = sdhci->reg->skew_ctrl;
+	rval = smhc_read(sdhci, skew_ctrl);
 	rval |= (0x1 << 4);
-	sdhci->reg->skew_ctrl = rval;
+	smhc_write(sdhci, skew_ctrl, rval);
 
 	return 0;
 }
 
 static bool update_card_clock(sdhci_t *sdhci)
 {
-	sdhci->reg->cmd = SMHC_CMD_START | SMHC_CMD_UPCLK_ONLY | SMHC_CMD_WAIT_PRE_OVER;
+	smhc_write(sdhci, cmd, SMHC_CMD_START | SMHC_CMD_UPCLK_ONLY | SMHC_CMD_WAIT_PRE_OVER);
 	u32 timeout		= time_ms();
 
 	do {
 		if (time_ms() - timeout > 10)
 			return FALSE;
-	} while (sdhci->reg->cmd & SMHC_CMD_START);
+	} while (smhc_read(sdhci, cmd) & SMHC_CMD_START);
 
-	sdhci->reg->rint = 0xffffffff;
+	smhc_write(sdhci, rint, 0xffffffff);
 	return TRUE;
 }
 
 bool sdhci_set_clock(sdhci_t *sdhci, smhc_clk_t clock)
 {
 	u32 div, n, mod_hz, pll, pll_hz, hz;
+	u32 clk_cfg	 = sunxi_soc.ccu_base + sunxi_soc.ccu_smhc0_clk;
+	u32 smhc_bgr = sunxi_soc.ccu_base + sunxi_soc.ccu_smhc_bgr;
 
 	switch (clock) {
 		case MMC_CLK_400K:
@@ -727,26 +737,26 @@ bool sdhci_set_clock(sdhci_t *sdhci, smhc_clk_t clock)
 
 	trace("SMHC: clock ratio %" PRIu32 "\r\n", div);
 
-	sdhci->reg->clkcr &= ~SMHC_CLKCR_CARD_CLOCK_ON; // Disable clock
+	smhc_write(sdhci, clkcr, smhc_read(sdhci, clkcr) & ~SMHC_CLKCR_CARD_CLOCK_ON); // Disable clock
 	if (!update_card_clock(sdhci))
 		return false;
 
-	sdhci->reg->ntsr |= SUNXI_MMC_NTSR_MODE_SEL_NEW;
+	smhc_write(sdhci, ntsr, smhc_read(sdhci, ntsr) | SUNXI_MMC_NTSR_MODE_SEL_NEW);
 
-	ccu->smhc_gate_reset |= CCU_MMC_BGR_SMHC0_RST;
-	ccu->smhc0_clk_cfg &= (~CCU_MMC_CTRL_ENABLE);
-	ccu->smhc0_clk_cfg = pll | CCU_MMC_CTRL_N(n) | CCU_MMC_CTRL_M(div);
-	ccu->smhc0_clk_cfg |= CCU_MMC_CTRL_ENABLE;
-	ccu->smhc_gate_reset |= CCU_MMC_BGR_SMHC0_GATE;
+	write32(smhc_bgr, read32(smhc_bgr) | CCU_MMC_BGR_SMHC0_RST);
+	write32(clk_cfg, read32(clk_cfg) & ~CCU_MMC_CTRL_ENABLE);
+	write32(clk_cfg, pll | CCU_MMC_CTRL_N(n) | CCU_MMC_CTRL_M(div));
+	write32(clk_cfg, read32(clk_cfg) | CCU_MMC_CTRL_ENABLE);
+	write32(smhc_bgr, read32(smhc_bgr) | CCU_MMC_BGR_SMHC0_GATE);
 
 	sdhci->pclk = mod_hz;
 
-	sdhci->reg->clkcr |= SMHC_CLKCR_MASK_D0; // Mask D0 when updating
-	sdhci->reg->clkcr &= ~(0xff); // Clear div (set to 1)
+	smhc_write(sdhci, clkcr, smhc_read(sdhci, clkcr) | SMHC_CLKCR_MASK_D0); // Mask D0 when updating
+	smhc_write(sdhci, clkcr, smhc_read(sdhci, clkcr) & ~(0xff)); // Clear div (set to 1)
 	if (sdhci->clock == MMC_CLK_50M_DDR) {
-		sdhci->reg->clkcr |= SMHC_CLKCR_CLOCK_DIV(2);
+		smhc_write(sdhci, clkcr, smhc_read(sdhci, clkcr) | SMHC_CLKCR_CLOCK_DIV(2));
 	}
-	sdhci->reg->clkcr |= SMHC_CLKCR_CARD_CLOCK_ON; // Enable clock
+	smhc_write(sdhci, clkcr, smhc_read(sdhci, clkcr) | SMHC_CLKCR_CARD_CLOCK_ON); // Enable clock
 
 	if (!update_card_clock(sdhci))
 		return false;
@@ -779,8 +789,8 @@ int sunxi_sdhci_init(sdhci_t *sdhci)
 	init_default_timing(sdhci);
 	sdhci_set_clock(sdhci, MMC_CLK_400K);
 
-	sdhci->reg->gctrl = SMHC_GCTRL_HARDWARE_RESET;
-	sdhci->reg->rint  = 0xffffffff;
+	smhc_write(sdhci, gctrl, SMHC_GCTRL_HARDWARE_RESET);
+	smhc_write(sdhci, rint, 0xffffffff);
 
 	sdhci->dma_trglvl = ((0x3 << 28) | (15 << 16) | 240);
 
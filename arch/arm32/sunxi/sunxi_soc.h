@@ -0,0 +1,40 @@
+#ifndef __SUNXI_SOC_H__
+#define __SUNXI_SOC_H__
+
+#include <inttypes.h>
+
+/*
+ * What the shared drivers in arch/arm32/sunxi need to know about a SoC.
+ * Each mach-* directory defines sunxi_soc in its soc.h, the drivers only
+ * read constant fields so they fold like the macros they replace.
+ */
+typedef struct {
+	const char *name;
+	uint32_t	ccu_base;
+	uint32_t	gpio_base;
+	uint32_t	gpio_ports; // BIT(PORTx) of the ports present
+	uint32_t	uart_base;	// UART0, the others follow every 0x400
+	uint32_t	dma_base;
+	uint32_t	spi_mod_clk; // SPI module clock from PLL_PERI(1x)
+	uint16_t	dram_clk_max; // MHz, faster board DRAM profiles are skipped
+
+	// CCU registers used by the drivers
+	uint16_t ccu_dma_bgr;
+	uint16_t ccu_mbus_gate;
+	uint16_t ccu_smhc0_clk;
+	uint16_t ccu_smhc_bgr;
+	uint16_t ccu_uart_bgr;
+	uint16_t ccu_spi0_clk;
+	uint16_t ccu_spi_bgr;
+} sunxi_soc_t;
+
+/* Rates in Hz chosen by sunxi_clk_init() of each mach-* directory */
+typedef struct {
+	uint32_t cpu;
+	uint32_t axi;
+	uint32_t psi; // AHB
+	uint32_t apb0;
+	uint32_t apb1;
+} sunxi_clk_plan_t;
+
+#endif
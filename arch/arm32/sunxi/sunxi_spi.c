@@ -25,7 +25,7 @@
  *
  */
 
-#include "reg-ccu.h"
+#include "soc.h"
 #include "sunxi_spi.h"
 #include "sunxi_clk.h"
 #include "sunxi_dma.h"
@@ -66,6 +66,24 @@ enum {
 	OPCODE_RESET			 = 0xff,
 };
 
+/* SPI-NOR only opcodes */
+enum {
+	OPCODE_NOR_READ_SR1			= 0x05,
+	OPCODE_NOR_READ_SR2			= 0x35,
+	OPCODE_NOR_READ_SR2_ALT		= 0x3f,
+	OPCODE_NOR_WRITE_SR			= 0x01,
+	OPCODE_NOR_WRITE_SR2		= 0x31,
+	OPCODE_NOR_WRITE_SR2_ALT	= 0x3e,
+	OPCODE_NOR_READ_SFDP		= 0x5a,
+	OPCODE_NOR_RESET_ENABLE		= 0x66,
+	OPCODE_NOR_RESET			= 0x99,
+	OPCODE_NOR_READ_4B			= 0x13,
+	OPCODE_NOR_FAST_READ_4B		= 0x0c,
+	OPCODE_NOR_READ_DUAL_O_4B	= 0x3c,
+	OPCODE_NOR_READ_QUAD_O_4B	= 0x6c,
+	OPCODE_NOR_READ_QUAD_IO_4B	= 0xec,
+};
+
 /* Micron calls it "feature", Winbond "status".
    We'll call it config for simplicity. */
 enum {
@@ -73,6 +91,7 @@ enum {
 	CONFIG_ADDR_OTP		= 0xb0,
 	CONFIG_ADDR_STATUS	= 0xc0,
 	CONFIG_POS_BUF		= 0x08, // Micron specific
+	CONFIG_POS_QE		= 0x01, // Gigadevice and Macronix
 };
 
 enum {
@@ -117,7 +136,7 @@ enum {
 
 enum {
 	SPI_FCR_RX_LEVEL_POS  = 0,
-	SPI_FCR_RX_LEVEL_MSK  = (0xff < SPI_FCR_RX_LEVEL_POS),
+	SPI_FCR_RX_LEVEL_MSK  = (0xff << SPI_FCR_RX_LEVEL_POS),
 	SPI_FCR_RX_DRQEN_POS  = 8,
 	SPI_FCR_RX_DRQEN_MSK  = (0x1 << SPI_FCR_RX_DRQEN_POS),
 	SPI_FCR_RX_TESTEN_POS = 14,
@@ -146,6 +165,7 @@ typedef enum {
 	SPI_NAND_MFR_GIGADEVICE = 0xc8,
 	SPI_NAND_MFR_MACRONIX	= 0xc2,
 	SPI_NAND_MFR_MICRON		= 0x2c,
+	SPI_NAND_MFR_FORESEE	= 0xcd,
 } spi_mfr_id;
 
 static const spi_nand_info_t spi_nand_infos[] = {
@@ -171,25 +191,28 @@ static const spi_nand_info_t spi_nand_infos[] = {
 	{ "GD5F4GQ4RCxIG", {.mfr = SPI_NAND_MFR_GIGADEVICE, .dev = 0xa4, 1}, 4096, 256, 64, 2048, 1, 1, SPI_IO_QUAD_RX},
 
  /* Macronix */
-	{	 "MX35LF1GE4AB",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x12, 1}, 2048,  64, 64, 1024, 1, 1, SPI_IO_DUAL_RX},
-	{	 "MX35LF1G24AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x14, 1}, 2048, 128, 64, 1024, 1, 1, SPI_IO_DUAL_RX},
-	{	 "MX31LF1GE4BC",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x1e, 1}, 2048,  64, 64, 1024, 1, 1, SPI_IO_DUAL_RX},
-	{	 "MX35LF2GE4AB",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x22, 1}, 2048,  64, 64, 2048, 1, 1, SPI_IO_DUAL_RX},
-	{	 "MX35LF2G24AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x24, 1}, 2048, 128, 64, 2048, 1, 1, SPI_IO_DUAL_RX},
-	{	 "MX35LF2GE4AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x26, 1}, 2048, 128, 64, 2048, 1, 1, SPI_IO_DUAL_RX},
-	{	 "MX35LF2G14AC",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x20, 1}, 2048,  64, 64, 2048, 1, 1, SPI_IO_DUAL_RX},
-	{	 "MX35LF4G24AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x35, 1}, 4096, 256, 64, 2048, 1, 1, SPI_IO_DUAL_RX},
-	{	 "MX35LF4GE4AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x37, 1}, 4096, 256, 64, 2048, 1, 1, SPI_IO_DUAL_RX},
+	{	 "MX35LF1GE4AB",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x12, 1}, 2048,  64, 64, 1024, 1, 1, SPI_IO_QUAD_RX},
+	{	 "MX35LF1G24AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x14, 1}, 2048, 128, 64, 1024, 1, 1, SPI_IO_QUAD_RX},
+	{	 "MX31LF1GE4BC",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x1e, 1}, 2048,  64, 64, 1024, 1, 1, SPI_IO_QUAD_RX},
+	{	 "MX35LF2GE4AB",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x22, 1}, 2048,  64, 64, 2048, 1, 1, SPI_IO_QUAD_RX},
+	{	 "MX35LF2G24AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x24, 1}, 2048, 128, 64, 2048, 1, 1, SPI_IO_QUAD_RX},
+	{	 "MX35LF2GE4AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x26, 1}, 2048, 128, 64, 2048, 1, 1, SPI_IO_QUAD_RX},
+	{	 "MX35LF2G14AC",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x20, 1}, 2048,  64, 64, 2048, 1, 1, SPI_IO_QUAD_RX},
+	{	 "MX35LF4G24AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x35, 1}, 4096, 256, 64, 2048, 1, 1, SPI_IO_QUAD_RX},
+	{	 "MX35LF4GE4AD",	 {.mfr = SPI_NAND_MFR_MACRONIX, .dev = 0x37, 1}, 4096, 256, 64, 2048, 1, 1, SPI_IO_QUAD_RX},
 
  /* Micron */
-	{"MT29F1G01AAADD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x12, 1}, 2048,  64, 64, 1024, 1, 1, SPI_IO_DUAL_RX},
-	{"MT29F1G01ABAFD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x14, 1}, 2048, 128, 64, 1024, 1, 1, SPI_IO_DUAL_RX},
-	{"MT29F2G01AAAED",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x9f, 1}, 2048,  64, 64, 2048, 2, 1, SPI_IO_DUAL_RX},
-	{"MT29F2G01ABAGD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x24, 1}, 2048, 128, 64, 2048, 2, 1, SPI_IO_DUAL_RX},
-	{"MT29F4G01AAADD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x32, 1}, 2048,  64, 64, 4096, 2, 1, SPI_IO_DUAL_RX},
-	{"MT29F4G01ABAFD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x34, 1}, 4096, 256, 64, 2048, 1, 1, SPI_IO_DUAL_RX},
-	{"MT29F4G01ADAGD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x36, 1}, 2048, 128, 64, 2048, 2, 2, SPI_IO_DUAL_RX},
-	{"MT29F8G01ADAFD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x46, 1}, 4096, 256, 64, 2048, 1, 2, SPI_IO_DUAL_RX},
+	{"MT29F1G01AAADD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x12, 1}, 2048,  64, 64, 1024, 1, 1, SPI_IO_QUAD_RX},
+	{"MT29F1G01ABAFD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x14, 1}, 2048, 128, 64, 1024, 1, 1, SPI_IO_QUAD_RX},
+	{"MT29F2G01AAAED",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x9f, 1}, 2048,  64, 64, 2048, 2, 1, SPI_IO_QUAD_RX},
+	{"MT29F2G01ABAGD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x24, 1}, 2048, 128, 64, 2048, 2, 1, SPI_IO_QUAD_RX},
+	{"MT29F4G01AAADD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x32, 1}, 2048,  64, 64, 4096, 2, 1, SPI_IO_QUAD_RX},
+	{"MT29F4G01ABAFD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x34, 1}, 4096, 256, 64, 2048, 1, 1, SPI_IO_QUAD_RX},
+	{"MT29F4G01ADAGD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x36, 1}, 2048, 128, 64, 2048, 2, 2, SPI_IO_QUAD_RX},
+	{"MT29F8G01ADAFD",	   {.mfr = SPI_NAND_MFR_MICRON, .dev = 0x46, 1}, 4096, 256, 64, 2048, 1, 2, SPI_IO_QUAD_RX},
+
+	/* Foresee */
+	{	"FS35SQA001G",   {.mfr = SPI_NAND_MFR_FORESEE, .dev = 0x7171, 2}, 2048,  64, 64, 1024, 1, 1, SPI_IO_QUAD_RX},
 };
 
 sunxi_spi_t		*spip;
@@ -203,16 +226,17 @@ static u32		 spi_rx_dma_hd;
 #define SPI_CLK_CTL_CDR1(div) (((div)&SPI_CLK_CTL_CDR1_MASK) << 8)
 #define SPI_CLK_CTL_DRS		  (0x1 << 12) /* Divide rate select,default,0:rate 1;1:rate 2 */
 
-#define SPI_MOD_CLK 200000000
+/* 16MB at the slowest single IO clock stays well below this */
+#define SPI_DMA_TIMEOUT_MS 10000
 
 static uint32_t spi_set_clk(sunxi_spi_t *spi, u32 spi_clk, u32 mclk, u32 cdr2)
 {
 	uint32_t reg	 = 0;
 	uint32_t div	 = 1;
 	uint32_t src_clk = mclk;
-	uint32_t freq	 = SPI_MOD_CLK;
+	uint32_t freq	 = mclk;
 
-	if (spi_clk != SPI_MOD_CLK) {
+	if (spi_clk != mclk) {
 		/* CDR2 */
 		if (cdr2) {
 			div = mclk / (spi_clk * 2) - 1;
@@ -291,11 +315,17 @@ static int spi_clk_init(uint32_t mod_clk)
 	factor_m = m - 1;
 	rval	 = (1U << 31) | (0x1 << 24) | (n << 8) | factor_m;
 	trace("SPI: parent_clk=%" PRIu32 "MHz, div=%" PRIu32 ", n=%" PRIu32 ", m=%" PRIu32 "\r\n", source_clk / 1000 / 1000, divi, n + 1, m);
-	write32(T113_CCU_BASE + CCU_SPI0_CLK_REG, rval);
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi0_clk, rval);
 
 	return 0;
 }
 
+/* Bytes moved per DMA request, the RX FIFO trigger level must match it */
+static uint32_t spi_dma_block_size(sunxi_spi_t *spi)
+{
+	return spi->dma_width * spi->dma_burst;
+}
+
 static void spi_reset_fifo(sunxi_spi_t *spi)
 {
 	uint32_t val = read32(spi->base + SPI_FCR);
@@ -303,7 +333,8 @@ static void spi_reset_fifo(sunxi_spi_t *spi)
 	val |= (SPI_FCR_RX_RST_MSK | SPI_FCR_TX_RST_MSK);
 	/* Set the trigger level of RxFIFO/TxFIFO. */
 	val &= ~(SPI_FCR_RX_LEVEL_MSK | SPI_FCR_TX_LEVEL_MSK | SPI_FCR_RX_DRQEN_MSK);
-	val |= (0x20 << SPI_FCR_TX_LEVEL_POS) | (0x20 << SPI_FCR_RX_LEVEL_POS); // IRQ trigger at 32 bytes (half fifo)
+	val |= (0x20 << SPI_FCR_TX_LEVEL_POS); // TX trigger at 32 bytes (half fifo)
+	val |= (spi_dma_block_size(spi) << SPI_FCR_RX_LEVEL_POS); // RX DRQ once a full DMA burst is available
 	write32(spi->base + SPI_FCR, val);
 }
 
@@ -323,8 +354,55 @@ inline static uint32_t spi_query_rxfifo(sunxi_spi_t *spi)
 	return val;
 }
 
-static int spi_dma_cfg(void)
+static int spi_dma_cfg(sunxi_spi_t *spi)
 {
+	uint32_t width, burst;
+
+	// Defaults: 16-bit, 8 beats
+	if (spi->dma_width == 0)
+		spi->dma_width = 2;
+	if (spi->dma_burst == 0)
+		spi->dma_burst = 8;
+
+	switch (spi->dma_width) {
+		case 1:
+			width = DMAC_CFG_SRC_DATA_WIDTH_8BIT;
+			break;
+		case 2:
+			width = DMAC_CFG_SRC_DATA_WIDTH_16BIT;
+			break;
+		case 4:
+			width = DMAC_CFG_SRC_DATA_WIDTH_32BIT;
+			break;
+		default:
+			error("SPI: invalid DMA width %u\r\n", spi->dma_width);
+			return -1;
+	}
+
+	switch (spi->dma_burst) {
+		case 1:
+			burst = DMAC_CFG_SRC_1_BURST;
+			break;
+		case 4:
+			burst = DMAC_CFG_SRC_4_BURST;
+			break;
+		case 8:
+			burst = DMAC_CFG_SRC_8_BURST;
+			break;
+		case 16:
+			burst = DMAC_CFG_SRC_16_BURST;
+			break;
+		default:
+			error("SPI: invalid DMA burst %u\r\n", spi->dma_burst);
+			return -1;
+	}
+
+	// A burst must fit in the 64 bytes RX FIFO
+	if (spi_dma_block_size(spi) > 64) {
+		error("SPI: DMA burst larger than FIFO\r\n");
+		return -1;
+	}
+
 	spi_rx_dma_hd = dma_request(DMAC_DMATYPE_NORMAL);
 
 	if ((spi_rx_dma_hd == 0)) {
@@ -338,22 +416,24 @@ static int spi_dma_cfg(void)
 
 	spi_rx_dma.channel_cfg.src_drq_type		= DMAC_CFG_TYPE_SPI0; /* SPI0 */
 	spi_rx_dma.channel_cfg.src_addr_mode	= DMAC_CFG_SRC_ADDR_TYPE_IO_MODE;
-	spi_rx_dma.channel_cfg.src_burst_length = DMAC_CFG_SRC_8_BURST;
-	spi_rx_dma.channel_cfg.src_data_width	= DMAC_CFG_SRC_DATA_WIDTH_16BIT;
+	spi_rx_dma.channel_cfg.src_burst_length = burst;
+	spi_rx_dma.channel_cfg.src_data_width	= width;
 	spi_rx_dma.channel_cfg.reserved0		= 0;
 
 	spi_rx_dma.channel_cfg.dst_drq_type		= DMAC_CFG_TYPE_DRAM; /* DRAM */
 	spi_rx_dma.channel_cfg.dst_addr_mode	= DMAC_CFG_DEST_ADDR_TYPE_LINEAR_MODE;
-	spi_rx_dma.channel_cfg.dst_burst_length = DMAC_CFG_DEST_8_BURST;
-	spi_rx_dma.channel_cfg.dst_data_width	= DMAC_CFG_DEST_DATA_WIDTH_16BIT;
+	spi_rx_dma.channel_cfg.dst_burst_length = burst;
+	spi_rx_dma.channel_cfg.dst_data_width	= width;
 	spi_rx_dma.channel_cfg.reserved1		= 0;
 
+	debug("SPI: RX DMA %u-bit, %u beats burst\r\n", spi->dma_width * 8, spi->dma_burst);
+
 	return 0;
 }
 
-static int spi_dma_init(void)
+static int spi_dma_init(sunxi_spi_t *spi)
 {
-	if (spi_dma_cfg()) {
+	if (spi_dma_cfg(spi)) {
 		return -1;
 	}
 	dma_setting(spi_rx_dma_hd, &spi_rx_dma);
@@ -387,22 +467,22 @@ int sunxi_spi_init(sunxi_spi_t *spi)
 	sunxi_gpio_set_drive_lvl(spi->gpio_hold.pin, 3);
 
 	/* Deassert spi0 reset */
-	val = read32(T113_CCU_BASE + CCU_SPI_BGR_REG);
+	val = read32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr);
 	val |= (1 << 16);
-	write32(T113_CCU_BASE + CCU_SPI_BGR_REG, val);
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr, val);
 
 	/* Open the spi0 gate */
-	val = read32(T113_CCU_BASE + CCU_SPI_BGR_REG);
+	val = read32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr);
 	val |= (1 << 31);
-	write32(T113_CCU_BASE + CCU_SPI_BGR_REG, val);
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr, val);
 
 	/* Open the spi0 bus gate */
-	val = read32(T113_CCU_BASE + CCU_SPI_BGR_REG);
+	val = read32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr);
 	val |= (1 << 0);
-	write32(T113_CCU_BASE + CCU_SPI_BGR_REG, val);
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr, val);
 
-	spi_clk_init(SPI_MOD_CLK);
-	freq = spi_set_clk(spi, spi->clk_rate, SPI_MOD_CLK, 1);
+	spi_clk_init(sunxi_soc.spi_mod_clk);
+	freq = spi_set_clk(spi, spi->clk_rate, sunxi_soc.spi_mod_clk, 1);
 
 	/* Enable spi0 and do a soft reset */
 	val = SPI_GCR_SRST_MSK | SPI_GCR_TPEN_MSK | SPI_GCR_MODE_MSK | SPI_GCR_EN_MSK;
@@ -421,8 +501,9 @@ int sunxi_spi_init(sunxi_spi_t *spi)
 		val |= SPI_TCR_SDM_MSK; // Set SDM bit when below 24MHz
 	write32(spi->base + SPI_TCR, val);
 
+	if (spi_dma_init(spi) != 0)
+		return -1;
 	spi_reset_fifo(spi);
-	spi_dma_init();
 
 	return 0;
 }
@@ -437,14 +518,14 @@ void sunxi_spi_disable(sunxi_spi_t *spi)
 	write32(spi->base + SPI_GCR, val);
 
 	/* close the spi0 bus gate */
-	val = read32(T113_CCU_BASE + CCU_SPI_BGR_REG);
+	val = read32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr);
 	val &= ~((1 << 0) | (1 << 31));
-	write32(T113_CCU_BASE + CCU_SPI_BGR_REG, val);
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr, val);
 
 	/* Assert spi0 reset */
-	val = read32(T113_CCU_BASE + CCU_SPI_BGR_REG);
+	val = read32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr);
 	val &= ~(1 << 16);
-	write32(T113_CCU_BASE + CCU_SPI_BGR_REG, val);
+	write32(sunxi_soc.ccu_base + sunxi_soc.ccu_spi_bgr, val);
 }
 
 /*
@@ -529,9 +610,17 @@ static void spi_set_io_mode(sunxi_spi_t *spi, spi_io_mode_t mode)
 	write32(spi->base + SPI_BCC, bcc);
 }
 
+// Nothing of a failed RX DMA may write to the buffer later, on a retry
+static void spi_dma_abort(sunxi_spi_t *spi, uint32_t fcr)
+{
+	write32(spi->base + SPI_FCR, (fcr & ~SPI_FCR_RX_DRQEN_MSK));
+	dma_stop(spi_rx_dma_hd);
+	spi_reset_fifo(spi);
+}
+
 static int spi_transfer(sunxi_spi_t *spi, spi_io_mode_t mode, void *txbuf, uint32_t txlen, void *rxbuf, uint32_t rxlen)
 {
-	uint32_t stxlen, fcr;
+	uint32_t stxlen, fcr, dmalen;
 	trace("SPI: tsfr mode=%u tx=%" PRIu32 " rx=%" PRIu32 "\r\n", mode, txlen, rxlen);
 
 	spi_set_io_mode(spi, mode);
@@ -568,16 +657,27 @@ static int spi_transfer(sunxi_spi_t *spi, spi_io_mode_t mode, void *txbuf, uint3
 
 	// Setup DMA for RX
 	if (rxbuf && rxlen) {
-		if (rxlen > 64) {
+		// DMA whole bursts only, the CPU drains the tail so the DRQ never waits on a partial burst
+		dmalen = rxlen & ~(spi_dma_block_size(spi) - 1);
+		if (rxlen <= 64 || ((u32)rxbuf & (spi->dma_width - 1)))
+			dmalen = 0;
+
+		if (dmalen) {
 			write32(spi->base + SPI_FCR, (fcr | SPI_FCR_RX_DRQEN_MSK)); // Enable RX FIFO DMA request
-			if (dma_start(spi_rx_dma_hd, spi->base + SPI_RXD, (u32)rxbuf, rxlen) != 0) {
+			if (dma_start(spi_rx_dma_hd, spi->base + SPI_RXD, (u32)rxbuf, dmalen) != 0) {
 				error("SPI: DMA transfer failed\r\n");
+				spi_dma_abort(spi, fcr);
 				return -1;
 			}
-			while (dma_querystatus(spi_rx_dma_hd)) {
-			};
-		} else {
-			spi_read_rx_fifo(spi, rxbuf, rxlen);
+			if (dma_wait(spi_rx_dma_hd, SPI_DMA_TIMEOUT_MS) != 0) {
+				error("SPI: DMA transfer timeout\r\n");
+				spi_dma_abort(spi, fcr);
+				return -1;
+			}
+			write32(spi->base + SPI_FCR, (fcr & ~SPI_FCR_RX_DRQEN_MSK));
+		}
+		if (rxlen > dmalen) {
+			spi_read_rx_fifo(spi, (uint8_t *)rxbuf + dmalen, rxlen - dmalen);
 		}
 	}
 
@@ -688,6 +788,143 @@ static void spi_nand_wait_while_busy(sunxi_spi_t *spi)
 	} while ((rx[0] & 0x1) == 0x1); // SR3 Busy bit
 }
 
+static int spi_nand_quad_enable(sunxi_spi_t *spi)
+{
+	uint8_t val;
+
+	switch (spi->info.id.mfr) {
+		case SPI_NAND_MFR_GIGADEVICE:
+		case SPI_NAND_MFR_MACRONIX:
+		case SPI_NAND_MFR_FORESEE:
+			// QE bit lives in the OTP/feature register
+			if (spi_nand_get_config(spi, CONFIG_ADDR_OTP, &val) != 0)
+				return -1;
+			if (!(val & CONFIG_POS_QE)) {
+				debug("SPI-NAND: enable quad mode\r\n");
+				val |= CONFIG_POS_QE;
+				spi_nand_set_config(spi, CONFIG_ADDR_OTP, val);
+				spi_nand_wait_while_busy(spi);
+			}
+			break;
+		case SPI_NAND_MFR_WINBOND:
+		case SPI_NAND_MFR_MICRON:
+		default:
+			// No QE bit, quad reads are always available
+			break;
+	}
+
+	return 0;
+}
+
+static int spi_nand_load_page(sunxi_spi_t *spi, uint32_t offset)
+{
+	uint32_t pa;
+	uint8_t	 tx[4];
+
+	pa = offset / spi->info.page_size;
+
+	tx[0] = OPCODE_READ_PAGE;
+	tx[1] = (uint8_t)(pa >> 16);
+	tx[2] = (uint8_t)(pa >> 8);
+	tx[3] = (uint8_t)(pa >> 0);
+
+	spi_transfer(spi, SPI_IO_SINGLE, tx, 4, 0, 0);
+	spi_nand_wait_while_busy(spi);
+
+	return 0;
+}
+
+/*
+ * Extra dummy bytes after the column address. Winbond parts run in continuous
+ * mode (BUF cleared in detect), where the fast reads take one more byte than
+ * the 03h read.
+ */
+static uint32_t spi_nand_read_dummies(sunxi_spi_t *spi, spi_io_mode_t mode)
+{
+	if (spi->info.id.mfr == (uint8_t)SPI_NAND_MFR_WINBOND && mode != SPI_IO_SINGLE)
+		return 1;
+
+	return 0;
+}
+
+/*
+ * Read from the page cache at column ca using the given IO mode.
+ */
+static int spi_nand_read_cache(sunxi_spi_t *spi, spi_io_mode_t mode, uint32_t ca, uint8_t *buf, uint32_t len)
+{
+	uint32_t txlen = 4;
+	uint8_t	 tx[6];
+
+	switch (mode) {
+		case SPI_IO_SINGLE:
+			tx[0] = OPCODE_READ;
+			break;
+		case SPI_IO_DUAL_RX:
+			tx[0] = OPCODE_FAST_READ_DUAL_O;
+			break;
+		case SPI_IO_QUAD_RX:
+			tx[0] = OPCODE_FAST_READ_QUAD_O;
+			break;
+		case SPI_IO_QUAD_IO:
+			tx[0] = OPCODE_FAST_READ_QUAD_IO;
+			txlen = 5; // Quad IO has 2 dummy bytes
+			break;
+		default:
+			error("SPI-NAND: invalid mode\r\n");
+			return -1;
+	};
+
+	txlen += spi_nand_read_dummies(spi, mode);
+
+	tx[1] = (uint8_t)(ca >> 8);
+	tx[2] = (uint8_t)(ca >> 0);
+	tx[3] = 0x0;
+	tx[4] = 0x0;
+	tx[5] = 0x0;
+
+	return spi_transfer(spi, mode, tx, txlen, buf, len);
+}
+
+/*
+ * Read the start of page 0 (boot0 header) in single and fast mode.
+ * Falls back to a narrower bus on mismatch (bad routing, QE not honored...).
+ */
+static void spi_nand_verify_mode(sunxi_spi_t *spi)
+{
+	uint8_t ref[64], buf[64];
+	int		i;
+
+	spi_nand_load_page(spi, 0);
+	spi_nand_read_cache(spi, SPI_IO_SINGLE, 0, ref, sizeof(ref));
+
+	for (i = 0; i < sizeof(ref); i++) {
+		if (ref[i] != 0xff)
+			break;
+	}
+	if (i == sizeof(ref)) {
+		debug("SPI-NAND: page 0 is blank, skipping mode test\r\n");
+		return;
+	}
+
+	while (spi->info.mode != SPI_IO_SINGLE) {
+		memset(buf, 0, sizeof(buf));
+		spi_nand_read_cache(spi, spi->info.mode, 0, buf, sizeof(buf));
+		if (memcmp(ref, buf, sizeof(buf)) == 0)
+			return;
+
+		warning("SPI-NAND: read check failed in mode %u, falling back\r\n", spi->info.mode);
+		switch (spi->info.mode) {
+			case SPI_IO_QUAD_IO:
+			case SPI_IO_QUAD_RX:
+				spi->info.mode = SPI_IO_DUAL_RX;
+				break;
+			default:
+				spi->info.mode = SPI_IO_SINGLE;
+				break;
+		}
+	}
+}
+
 int spi_nand_detect(sunxi_spi_t *spi)
 {
 	uint8_t val;
@@ -710,16 +947,14 @@ int spi_nand_detect(sunxi_spi_t *spi)
 			}
 		}
 
-		if (spi->info.id.mfr == (uint8_t)SPI_NAND_MFR_GIGADEVICE) {
-			if ((spi_nand_get_config(spi, CONFIG_ADDR_OTP, &val) == 0) && !(val & 0x01)) {
-				debug("SPI-NAND: enable Gigadevice Quad mode\r\n");
-				val |= (1 << 0);
-				spi_nand_set_config(spi, CONFIG_ADDR_OTP, val);
-				spi_nand_wait_while_busy(spi);
-			}
+		if (spi->info.mode == SPI_IO_QUAD_RX || spi->info.mode == SPI_IO_QUAD_IO) {
+			if (spi_nand_quad_enable(spi) != 0)
+				spi->info.mode = SPI_IO_DUAL_RX;
 		}
 
-		info("SPI-NAND: %s detected\r\n", spi->info.name);
+		spi_nand_verify_mode(spi);
+
+		info("SPI-NAND: %s detected, mode %u\r\n", spi->info.name, spi->info.mode);
 
 		return 0;
 	}
@@ -728,97 +963,381 @@ int spi_nand_detect(sunxi_spi_t *spi)
 	return -1;
 }
 
-static int spi_nand_load_page(sunxi_spi_t *spi, uint32_t offset)
+uint32_t spi_nand_read(sunxi_spi_t *spi, uint8_t *buf, uint32_t addr, uint32_t rxlen)
 {
-	uint32_t pa;
-	uint8_t	 tx[4];
+	uint32_t address = addr;
+	uint32_t cnt	 = rxlen;
+	uint32_t n;
+	uint32_t len = 0;
+	uint32_t ca;
 
-	pa = offset / spi->info.page_size;
+	if (addr % spi->info.page_size) {
+		error("spi_nand: address is not page-aligned\r\n");
+		return -1;
+	}
 
-	tx[0] = OPCODE_READ_PAGE;
-	tx[1] = (uint8_t)(pa >> 16);
-	tx[2] = (uint8_t)(pa >> 8);
-	tx[3] = (uint8_t)(pa >> 0);
+	if (spi->info.id.mfr == SPI_NAND_MFR_WINBOND) {
+		// With Winbond, we use continuous mode
+		// This allows us to not load each page
+		spi_nand_load_page(spi, addr);
+		if (spi_nand_read_cache(spi, spi->info.mode, 0, buf, rxlen) < 0)
+			return -1;
+		return rxlen;
+	}
 
-	spi_transfer(spi, SPI_IO_SINGLE, tx, 4, 0, 0);
-	spi_nand_wait_while_busy(spi);
+	while (cnt > 0) {
+		ca = address & (spi->info.page_size - 1);
+		n  = cnt > (spi->info.page_size - ca) ? (spi->info.page_size - ca) : cnt;
 
-	return 0;
+		spi_nand_load_page(spi, address);
+
+		// Multi-plane parts (Micron) select the plane with the column address
+		if (spi->info.planes_per_die > 1)
+			ca |= ((address / spi->info.page_size / spi->info.pages_per_block) & 1) << 12;
+
+		if (spi_nand_read_cache(spi, spi->info.mode, ca, buf, n) < 0)
+			return -1;
+
+		address += n;
+		buf += n;
+		len += n;
+		cnt -= n;
+	}
+
+	return len;
 }
 
-uint32_t spi_nand_read(sunxi_spi_t *spi, uint8_t *buf, uint32_t addr, uint32_t rxlen)
+/*
+ * SPI NOR functions
+ */
+
+#define SFDP_SIGNATURE	 0x50444653 // "SFDP"
+#define SFDP_BFPT_DWORDS 16
+/* Keep the whole transfer (tx + rx) within the 24-bit burst counter */
+#define SPI_NOR_MAX_XFER 0x00fff000
+
+static int spi_nor_read_sfdp(sunxi_spi_t *spi, uint32_t addr, void *buf, uint32_t len)
 {
-	uint32_t address = addr;
-	uint32_t cnt	 = rxlen;
-	uint32_t n;
-	uint32_t len = 0;
-	uint32_t ca;
-	uint32_t txlen = 4;
-	uint8_t	 tx[6];
+	uint8_t tx[5];
 
-	int read_opcode = OPCODE_READ;
-	switch (spi->info.mode) {
-		case SPI_IO_SINGLE:
-			read_opcode = OPCODE_READ;
+	tx[0] = OPCODE_NOR_READ_SFDP;
+	tx[1] = (uint8_t)(addr >> 16);
+	tx[2] = (uint8_t)(addr >> 8);
+	tx[3] = (uint8_t)(addr >> 0);
+	tx[4] = 0x0; // 8 dummy clocks
+
+	return spi_transfer(spi, SPI_IO_SINGLE, tx, 5, buf, len);
+}
+
+static uint8_t spi_nor_read_reg(sunxi_spi_t *spi, uint8_t opcode)
+{
+	uint8_t tx[1];
+	uint8_t rx[1];
+
+	tx[0] = opcode;
+	rx[0] = 0x0;
+	spi_transfer(spi, SPI_IO_SINGLE, tx, 1, rx, 1);
+
+	return rx[0];
+}
+
+static void spi_nor_wait_while_busy(sunxi_spi_t *spi)
+{
+	while (spi_nor_read_reg(spi, OPCODE_NOR_READ_SR1) & 0x1) { // WIP bit
+	};
+}
+
+static void spi_nor_write_reg(sunxi_spi_t *spi, uint8_t opcode, uint8_t *val, uint32_t len)
+{
+	uint8_t tx[3];
+
+	tx[0] = OPCODE_WRITE_ENABLE;
+	spi_transfer(spi, SPI_IO_SINGLE, tx, 1, 0, 0);
+
+	tx[0] = opcode;
+	memcpy(&tx[1], val, len);
+	spi_transfer(spi, SPI_IO_SINGLE, tx, len + 1, 0, 0);
+
+	spi_nor_wait_while_busy(spi);
+}
+
+/*
+ * Set the QE bit following the BFPT "Quad Enable Requirements" field (DWORD 15)
+ */
+static int spi_nor_quad_enable(sunxi_spi_t *spi, uint32_t qer)
+{
+	uint8_t sr[2];
+
+	switch (qer) {
+		case 0: // No QE bit
+			return 0;
+		case 1:
+		case 4:
+		case 5: // QE is bit 1 of SR2, written along SR1
+			sr[0] = spi_nor_read_reg(spi, OPCODE_NOR_READ_SR1);
+			sr[1] = spi_nor_read_reg(spi, OPCODE_NOR_READ_SR2);
+			if (sr[1] & (1 << 1))
+				return 0;
+			sr[1] |= (1 << 1);
+			spi_nor_write_reg(spi, OPCODE_NOR_WRITE_SR, sr, 2);
 			break;
-		case SPI_IO_DUAL_RX:
-			read_opcode = OPCODE_FAST_READ_DUAL_O;
+		case 2: // QE is bit 6 of SR1
+			sr[0] = spi_nor_read_reg(spi, OPCODE_NOR_READ_SR1);
+			if (sr[0] & (1 << 6))
+				return 0;
+			sr[0] |= (1 << 6);
+			spi_nor_write_reg(spi, OPCODE_NOR_WRITE_SR, sr, 1);
 			break;
-		case SPI_IO_QUAD_RX:
-			read_opcode = OPCODE_FAST_READ_QUAD_O;
+		case 3: // QE is bit 7 of SR2, with dedicated opcodes
+			sr[0] = spi_nor_read_reg(spi, OPCODE_NOR_READ_SR2_ALT);
+			if (sr[0] & (1 << 7))
+				return 0;
+			sr[0] |= (1 << 7);
+			spi_nor_write_reg(spi, OPCODE_NOR_WRITE_SR2_ALT, sr, 1);
 			break;
-		case SPI_IO_QUAD_IO:
-			read_opcode = OPCODE_FAST_READ_QUAD_IO;
-			txlen		= 5; // Quad IO has 2 dummy bytes
+		case 6: // QE is bit 1 of SR2, written alone
+			sr[0] = spi_nor_read_reg(spi, OPCODE_NOR_READ_SR2);
+			if (sr[0] & (1 << 1))
+				return 0;
+			sr[0] |= (1 << 1);
+			spi_nor_write_reg(spi, OPCODE_NOR_WRITE_SR2, sr, 1);
 			break;
-
 		default:
-			error("spi_nand: invalid mode\r\n");
 			return -1;
-	};
+	}
+	debug("SPI-NOR: quad mode enabled\r\n");
 
-	if (addr % spi->info.page_size) {
-		error("spi_nand: address is not page-aligned\r\n");
+	return 0;
+}
+
+/* Stateless 4-byte address opcodes, so a warm reset leaves the flash bootable by the BROM */
+static uint8_t spi_nor_opcode_4b(uint8_t opcode)
+{
+	switch (opcode) {
+		case OPCODE_READ:
+			return OPCODE_NOR_READ_4B;
+		case OPCODE_FAST_READ:
+			return OPCODE_NOR_FAST_READ_4B;
+		case OPCODE_FAST_READ_DUAL_O:
+			return OPCODE_NOR_READ_DUAL_O_4B;
+		case OPCODE_FAST_READ_QUAD_O:
+			return OPCODE_NOR_READ_QUAD_O_4B;
+		case OPCODE_FAST_READ_QUAD_IO:
+			return OPCODE_NOR_READ_QUAD_IO_4B;
+		default:
+			return opcode;
+	}
+}
+
+static void spi_nor_set_read(spi_nor_info_t *nor, spi_io_mode_t mode, uint8_t opcode, uint8_t dummy)
+{
+	nor->mode		 = mode;
+	nor->read_opcode = opcode;
+	nor->read_dummy	 = dummy;
+}
+
+/*
+ * Parse the JEDEC Basic Flash Parameter Table to get the size, the address width and the fastest read command
+ */
+static int spi_nor_parse_sfdp(sunxi_spi_t *spi)
+{
+	spi_nor_info_t *nor = &spi->nor;
+	uint32_t		hdr[4];
+	uint32_t		bfpt[SFDP_BFPT_DWORDS];
+	uint32_t		ptr, len, clocks;
+
+	if (spi_nor_read_sfdp(spi, 0, hdr, sizeof(hdr)) < 0)
+		return -1;
+
+	if (hdr[0] != SFDP_SIGNATURE) {
+		debug("SPI-NOR: no SFDP\r\n");
 		return -1;
 	}
 
-	if (spi->info.id.mfr == SPI_NAND_MFR_GIGADEVICE) {
-		while (cnt > 0) {
-			ca = address & (spi->info.page_size - 1);
-			n  = cnt > (spi->info.page_size - ca) ? (spi->info.page_size - ca) : cnt;
+	// First parameter header is always the BFPT
+	len = (hdr[2] >> 24) & 0xff;
+	ptr = hdr[3] & 0x00ffffff;
+	if ((hdr[2] & 0xff) != 0x00 || len < 9) {
+		debug("SPI-NOR: invalid BFPT header\r\n");
+		return -1;
+	}
+	len = min(len, SFDP_BFPT_DWORDS);
+
+	memset(bfpt, 0, sizeof(bfpt));
+	if (spi_nor_read_sfdp(spi, ptr, bfpt, len * 4) < 0)
+		return -1;
+
+	// DWORD 2: density
+	if (bfpt[1] & (1U << 31))
+		nor->size = 1U << (((bfpt[1] & 0x7fffffff) - 3) & 0x1f);
+	else
+		nor->size = (bfpt[1] + 1) / 8;
+
+	// DWORD 1: address bytes
+	switch ((bfpt[0] >> 17) & 0x3) {
+		case 0:
+			nor->addr_width = 3;
+			break;
+		case 1:
+			nor->addr_width = nor->size > MB(16) ? 4 : 3;
+			break;
+		default:
+			nor->addr_width = 4;
+			break;
+	}
 
-			spi_nand_load_page(spi, address);
+	spi_nor_set_read(nor, SPI_IO_SINGLE, OPCODE_FAST_READ, 1);
 
-			tx[0] = read_opcode;
-			tx[1] = (uint8_t)(ca >> 8);
-			tx[2] = (uint8_t)(ca >> 0);
-			tx[3] = 0x0;
+	// DWORD 4: 1-1-2
+	if (bfpt[0] & (1 << 16)) {
+		clocks = (bfpt[3] & 0x1f) + ((bfpt[3] >> 5) & 0x7);
+		if ((clocks % 8) == 0)
+			spi_nor_set_read(nor, SPI_IO_DUAL_RX, (bfpt[3] >> 8) & 0xff, clocks / 8);
+	}
 
-			spi_transfer(spi, spi->info.mode, tx, 4, buf, n);
+	// Quad reads need the QE requirements from DWORD 15
+	if (len < 15 || spi_nor_quad_enable(spi, (bfpt[14] >> 20) & 0x7) != 0)
+		return 0;
 
-			address += n;
-			buf += n;
-			len += n;
-			cnt -= n;
-		}
+	// DWORD 3: 1-1-4
+	if (bfpt[0] & (1 << 22)) {
+		clocks = ((bfpt[2] >> 16) & 0x1f) + ((bfpt[2] >> 21) & 0x7);
+		if ((clocks % 8) == 0)
+			spi_nor_set_read(nor, SPI_IO_QUAD_RX, (bfpt[2] >> 24) & 0xff, clocks / 8);
+	}
+
+	// DWORD 3: 1-4-4, mode and dummy clocks are sent on 4 lines
+	if (bfpt[0] & (1 << 21)) {
+		clocks = (bfpt[2] & 0x1f) + ((bfpt[2] >> 5) & 0x7);
+		if ((clocks % 2) == 0)
+			spi_nor_set_read(nor, SPI_IO_QUAD_IO, (bfpt[2] >> 8) & 0xff, clocks / 2);
+	}
+
+	return 0;
+}
+
+static int spi_nor_read_data(sunxi_spi_t *spi, spi_io_mode_t mode, uint8_t opcode, uint8_t dummy, uint32_t addr,
+							 uint8_t *buf, uint32_t len)
+{
+	spi_nor_info_t *nor	  = &spi->nor;
+	uint32_t		txlen = 0;
+	uint8_t			tx[16];
+
+	if (nor->addr_width == 4) {
+		tx[txlen++] = spi_nor_opcode_4b(opcode);
+		tx[txlen++] = (uint8_t)(addr >> 24);
 	} else {
-		spi_nand_load_page(spi, addr);
+		tx[txlen++] = opcode;
+	}
+	tx[txlen++] = (uint8_t)(addr >> 16);
+	tx[txlen++] = (uint8_t)(addr >> 8);
+	tx[txlen++] = (uint8_t)(addr >> 0);
 
-		// With Winbond, we use continuous mode which has 1 more dummy
-		// This allows us to not load each page
-		if (spi->info.id.mfr == SPI_NAND_MFR_WINBOND) {
-			txlen++;
-		}
+	// Mode bits are zero: no continuous read
+	memset(&tx[txlen], 0, dummy);
+	txlen += dummy;
 
-		ca = address & (spi->info.page_size - 1);
+	return spi_transfer(spi, mode, tx, txlen, buf, len);
+}
+
+/*
+ * Compare the start of the flash read in single and fast mode.
+ * Falls back to a narrower bus on mismatch.
+ */
+static void spi_nor_verify_mode(sunxi_spi_t *spi)
+{
+	spi_nor_info_t *nor = &spi->nor;
+	uint8_t			ref[64], buf[64];
+	int				i;
 
-		tx[0] = read_opcode;
-		tx[1] = (uint8_t)(ca >> 8);
-		tx[2] = (uint8_t)(ca >> 0);
-		tx[3] = 0x0;
-		tx[4] = 0x0;
+	spi_nor_read_data(spi, SPI_IO_SINGLE, OPCODE_READ, 0, 0, ref, sizeof(ref));
 
-		spi_transfer(spi, spi->info.mode, tx, txlen, buf, rxlen);
+	for (i = 0; i < sizeof(ref); i++) {
+		if (ref[i] != 0xff)
+			break;
 	}
-	return len;
+	if (i == sizeof(ref)) {
+		debug("SPI-NOR: flash start is blank, skipping mode test\r\n");
+		return;
+	}
+
+	while (nor->mode != SPI_IO_SINGLE) {
+		memset(buf, 0, sizeof(buf));
+		spi_nor_read_data(spi, nor->mode, nor->read_opcode, nor->read_dummy, 0, buf, sizeof(buf));
+		if (memcmp(ref, buf, sizeof(buf)) == 0)
+			return;
+
+		warning("SPI-NOR: read check failed in mode %u, falling back\r\n", nor->mode);
+		if (nor->mode != SPI_IO_DUAL_RX)
+			spi_nor_set_read(nor, SPI_IO_DUAL_RX, OPCODE_FAST_READ_DUAL_O, 1);
+		else
+			spi_nor_set_read(nor, SPI_IO_SINGLE, OPCODE_FAST_READ, 1);
+	}
+}
+
+int spi_nor_detect(sunxi_spi_t *spi)
+{
+	spi_nor_info_t *nor = &spi->nor;
+	uint8_t			tx[1];
+	uint8_t			rx[3];
+
+	// Exit any continuous/QPI state left by a previous user
+	tx[0] = OPCODE_NOR_RESET_ENABLE;
+	spi_transfer(spi, SPI_IO_SINGLE, tx, 1, 0, 0);
+	tx[0] = OPCODE_NOR_RESET;
+	spi_transfer(spi, SPI_IO_SINGLE, tx, 1, 0, 0);
+	udelay(100);
+
+	tx[0] = OPCODE_READ_ID;
+	if (spi_transfer(spi, SPI_IO_SINGLE, tx, 1, rx, 3) < 0)
+		return -1;
+
+	if (rx[0] == 0xff || rx[0] == 0x00) {
+		error("SPI-NOR: flash not found\r\n");
+		return -1;
+	}
+
+	memset(nor, 0, sizeof(spi_nor_info_t));
+	nor->mfr = rx[0];
+	nor->dev = ((uint16_t)rx[1] << 8) | rx[2];
+
+	if (spi_nor_parse_sfdp(spi) != 0) {
+		// Most vendors encode log2(size) in the capacity byte
+		nor->size		= (rx[2] >= 0x10 && rx[2] <= 0x1f) ? (1U << rx[2]) : MB(16);
+		nor->addr_width = nor->size > MB(16) ? 4 : 3;
+		spi_nor_set_read(nor, SPI_IO_SINGLE, OPCODE_FAST_READ, 1);
+	}
+
+	spi_nor_verify_mode(spi);
+
+	info("SPI-NOR: mfr:0x%02x dev:0x%04x %" PRIu32 "KB detected, mode %u, %u-byte address\r\n", nor->mfr, nor->dev,
+		 nor->size / 1024, nor->mode, nor->addr_width);
+
+	return 0;
+}
+
+/*
+ * NOR needs no page loads: read in one transfer, split only at the controller counter limit
+ */
+uint32_t spi_nor_read(sunxi_spi_t *spi, uint8_t *buf, uint32_t addr, uint32_t rxlen)
+{
+	spi_nor_info_t *nor = &spi->nor;
+	uint32_t		cnt = rxlen;
+	uint32_t		n;
+
+	if (addr + rxlen > nor->size) {
+		error("SPI-NOR: read beyond flash end\r\n");
+		return -1;
+	}
+
+	while (cnt > 0) {
+		n = min(cnt, SPI_NOR_MAX_XFER);
+		if (spi_nor_read_data(spi, nor->mode, nor->read_opcode, nor->read_dummy, addr, buf, n) < 0)
+			return -1;
+		addr += n;
+		buf += n;
+		cnt -= n;
+	}
+
+	return rxlen;
 }
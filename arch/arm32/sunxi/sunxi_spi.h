@@ -29,6 +29,16 @@ typedef struct {
 	spi_io_mode_t mode;
 } spi_nand_info_t;
 
+typedef struct {
+	uint8_t		  mfr;
+	uint16_t	  dev;
+	uint32_t	  size; // in bytes
+	uint8_t		  addr_width; // 3 or 4 bytes
+	uint8_t		  read_opcode;
+	uint8_t		  read_dummy; // dummy + mode bytes, sent in the read's address IO width
+	spi_io_mode_t mode;
+} spi_nor_info_t;
+
 typedef struct {
 	uint32_t   base;
 	uint8_t	   id;
@@ -39,13 +49,18 @@ typedef struct {
 	gpio_mux_t gpio_mosi;
 	gpio_mux_t gpio_wp;
 	gpio_mux_t gpio_hold;
+	uint8_t	   dma_width; // RX DMA bytes per beat: 1, 2 or 4 (default 2)
+	uint8_t	   dma_burst; // RX DMA beats per burst: 1, 4, 8 or 16 (default 8)
 
 	spi_nand_info_t info;
+	spi_nor_info_t	nor;
 } sunxi_spi_t;
 
 int		 sunxi_spi_init(sunxi_spi_t *spi);
 void	 sunxi_spi_disable(sunxi_spi_t *spi);
 int		 spi_nand_detect(sunxi_spi_t *spi);
 uint32_t spi_nand_read(sunxi_spi_t *spi, uint8_t *buf, uint32_t addr, uint32_t rxlen);
+int		 spi_nor_detect(sunxi_spi_t *spi);
+uint32_t spi_nor_read(sunxi_spi_t *spi, uint8_t *buf, uint32_t addr, uint32_t rxlen);
 
 #endif
@@ -2,7 +2,8 @@
 #include "io.h"
 #include "common.h"
 #include "sunxi_usart.h"
-#include "reg-ccu.h"
+#include "sunxi_clk.h"
+#include "soc.h"
 
 // Macros to access UART registers.
 #define UART_RBR(n) *(volatile uint32_t *)(UART_BASE(n) + 0x00)
@@ -35,18 +36,19 @@ void sunxi_usart_init(const sunxi_usart_t *usart, uint32_t baudrate)
 	sunxi_gpio_set_pull(usart->gpio_rx.pin, GPIO_PULL_UP);
 
 	/* Open the clock gate for usart */
-	addr = T113_CCU_BASE + CCU_USART_BGR_REG;
+	addr = sunxi_soc.ccu_base + sunxi_soc.ccu_uart_bgr;
 	val	 = read32(addr);
 	val |= 1 << usart->id;
 	write32(addr, val);
 
 	/* Deassert USART reset */
-	addr = T113_CCU_BASE + CCU_USART_BGR_REG;
+	addr = sunxi_soc.ccu_base + sunxi_soc.ccu_uart_bgr;
 	val	 = read32(addr);
 	val |= 1 << (16 + usart->id);
 	write32(addr, val);
 
-	div = 1500000 / baudrate;
+	// APB1 / 16 / div, rounded to the nearest rate
+	div = (sunxi_clk_get_plan()->apb1 + 8 * baudrate) / (16 * baudrate);
 
 	// Configure baud rate
 	UART_LCR(usart->id) = (1 << 7) | 3;
@@ -76,6 +78,27 @@ void sunxi_usart_put(sunxi_usart_t *usart, char *in, uint32_t len)
 	}
 }
 
+/* Write what the TX FIFO takes without waiting, returns the count written */
+uint32_t sunxi_usart_put_nb(const sunxi_usart_t *usart, const char *in, uint32_t len)
+{
+	uint32_t count = 0;
+
+	while (count < len && (UART_USR(usart->id) & UART_USR_TFNF)) {
+		UART_THR(usart->id) = in[count++];
+	}
+
+	return count;
+}
+
+/* Wait for the TX FIFO and shift register to be empty */
+void sunxi_usart_wait_tx(const sunxi_usart_t *usart)
+{
+	while ((UART_USR(usart->id) & UART_USR_TFE) == 0)
+		;
+	while ((UART_USR(usart->id) & UART_USR_BUSY) == 1)
+		;
+}
+
 void sunxi_usart_get(sunxi_usart_t *usart, char *out, uint32_t len)
 {
 	while (len--) {
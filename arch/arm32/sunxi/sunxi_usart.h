@@ -5,7 +5,7 @@
 #include "sunxi_gpio.h"
 
 // The UART registers base address.
-#define UART_BASE(id) ((uint32_t)(0x02500000 + (0x400 * id)))
+#define UART_BASE(id) ((uint32_t)(sunxi_soc.uart_base + (0x400 * id)))
 
 typedef struct {
 	uint32_t   base;
@@ -17,6 +17,8 @@ typedef struct {
 void sunxi_usart_init(const sunxi_usart_t *usart, uint32_t baudrate);
 void sunxi_usart_putc(void *arg, char c);
 void sunxi_usart_put(sunxi_usart_t *usart, char *in, uint32_t len);
+uint32_t sunxi_usart_put_nb(const sunxi_usart_t *usart, const char *in, uint32_t len);
+void sunxi_usart_wait_tx(const sunxi_usart_t *usart);
 void sunxi_usart_get(sunxi_usart_t *usart, char *out, uint32_t len);
 
 #endif
@@ -29,7 +29,6 @@
 #include "sunxi_wdg.h"
 #include "sunxi_clk.h"
 #include "common.h"
-#include "reg-ccu.h"
 #include "debug.h"
 #include "types.h"
 
@@ -4,11 +4,11 @@
 #include "sunxi_sdhci.h"
 #include "sunxi_usart.h"
 #include "sunxi_spi.h"
+#include "sunxi_wdg.h"
 #include "sdmmc.h"
 
 
-sunxi_usart_t usart_dbg = {
-	.base	 = 0x02500800,
+sunxi_usart_t usart2_dbg = {
 	.id		 = 2,
 	.gpio_tx = {GPIO_PIN(PORTE, 12), GPIO_PERIPH_MUX6},
 	.gpio_rx = {GPIO_PIN(PORTE, 13), GPIO_PERIPH_MUX6},
@@ -42,22 +42,73 @@ sdhci_t sdhci0 = {
 	.gpio_d3   = {GPIO_PIN(PORTF, 4), GPIO_PERIPH_MUX2},
 };
 
-gpio_t led_blue = GPIO_PIN(PORTF, 6);
+// 64MB in package DDR2, the size is scanned
+const dram_profile_t dram_profiles[] = {
+	{"ddr2-528",
+	 {
+		 .dram_clk	  = 528,
+		 .dram_type	  = SUNXI_DRAM_TYPE_DDR2,
+		 .dram_zq	  = 0x7b7bf9,
+		 .dram_odt_en = 0x0,
+		 .dram_para1  = 0x00d2,
+		 .dram_para2  = 0x0,
+		 .dram_mr0	  = 0xe73,
+		 .dram_mr1	  = 0x02,
+		 .dram_mr2	  = 0x0,
+		 .dram_mr3	  = 0x0,
+		 .dram_tpr0	  = 0x00471992,
+		 .dram_tpr1	  = 0x0131a10c,
+		 .dram_tpr2	  = 0x00057041,
+		 .dram_tpr3	  = 0xb4787896,
+		 .dram_tpr4	  = 0x0,
+		 .dram_tpr5	  = 0x48484848,
+		 .dram_tpr6	  = 0x48,
+		 .dram_tpr7	  = 0x1621121e,
+		 .dram_tpr8	  = 0x0,
+		 .dram_tpr9	  = 0x0,
+		 .dram_tpr10  = 0x00000000,
+		 .dram_tpr11  = 0x00000022,
+		 .dram_tpr12  = 0x00000077,
+		 .dram_tpr13  = 0x34000100,
+	 }},
+};
+const unsigned int dram_profile_count = ARRAY_SIZE(dram_profiles);
+
+static const gpio_t led_blue = GPIO_PIN(PORTF, 6);
 
-void board_init_led(gpio_t led)
+void board_set_led(uint8_t num, uint8_t on)
 {
-	sunxi_gpio_init(led, GPIO_OUTPUT);
-	sunxi_gpio_set_value(led, 0);
+	if (num == LED_BOARD)
+		sunxi_gpio_write(led_blue, on);
 }
 
-int board_sdhci_init()
+// No button and no supervising MCU on this board
+bool board_get_button()
 {
-	sunxi_sdhci_init(&sdhci0);
-	return sdmmc_init(&card0, &sdhci0);
+	return false;
+}
+
+bool board_get_power_on()
+{
+	return true;
+}
+
+void board_set_status(bool on)
+{
+	(void)on;
+}
+
+int board_get_dram_profile(void)
+{
+	return -1;
 }
 
 void board_init()
 {
-	board_init_led(led_blue);
-	sunxi_usart_init(&usart_dbg);
+	sunxi_gpio_init(led_blue, GPIO_OUTPUT);
+	sunxi_gpio_write(led_blue, 0);
+
+	sunxi_usart_init(&USART_DBG, USART_BAUDRATE);
+
+	sunxi_wdg_init();
 }
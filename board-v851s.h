@@ -0,0 +1,78 @@
+// Configuration of the V851s board in board-v851s.c, selected with make BOARD=board-v851s.
+// Same guard as board.h so the sources including "board.h" get this one.
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+#include "dram.h"
+#include "sunxi_spi.h"
+#include "sunxi_usart.h"
+#include "sunxi_sdhci.h"
+
+#define USART_DBG			   usart2_dbg
+#define USART_BAUDRATE		   115200
+#define CONFIG_LOG_BUFFER_SIZE 2048 // queued console output, power of two
+
+#define CONFIG_FATFS_CACHE_SIZE		 (CONFIG_DTB_LOAD_ADDR - SDRAM_BASE) // in bytes
+// #define CONFIG_FATFS_CACHE_RESERVE
+#define CONFIG_SDMMC_SPEED_TEST_SIZE 1024 // (unit: 512B sectors)
+#define RTC_BKP_REG(n)				 (*((uint32_t *)((0x07090100) + ((n) * 4))))
+
+#define MB(x) (x * 1024 * 1024)
+
+// 64MB of in package DDR2
+#define CONFIG_KERNEL_LOAD_ADDR	   (SDRAM_BASE + MB(24))
+#define CONFIG_DTB_LOAD_ADDR	   (SDRAM_BASE + MB(40))
+#define CONFIG_DTB_MAX_SIZE		   (256 * 1024)
+#define CONFIG_DTB_HEADROOM		   (12 * 1024)
+#define CONFIG_DTBO_LOAD_ADDR	   (CONFIG_DTB_LOAD_ADDR + 256 * 1024)
+#define CONFIG_DTBO_MAX_SIZE	   (256 * 1024)
+#define CONFIG_DTB_FIXUP_ADDR	   (CONFIG_DTB_LOAD_ADDR + 512 * 1024)
+#define CONFIG_DTB_FIXUP_SIZE	   (256 * 1024)
+#define CONFIG_FDT_ARENA_ADDR	   (CONFIG_DTB_LOAD_ADDR + 768 * 1024)
+#define CONFIG_FDT_ARENA_SIZE	   (252 * 1024)
+#define CONFIG_CMDLINE_ADDR		   (CONFIG_FDT_ARENA_ADDR + CONFIG_FDT_ARENA_SIZE)
+#define CONFIG_CMDLINE_SIZE		   (4 * 1024)
+#define CONFIG_INITRAMFS_LOAD_ADDR (SDRAM_BASE + MB(41))
+#define CONFIG_INITRAMFS_MAX_SIZE  MB(16)
+// The last MB of DRAM runs the DRAM_SRCS code, see link.ld
+
+#define CONFIG_CONF_FILENAME	 "boot.cfg"
+#define CONFIG_CONF_BIN_FILENAME "boot.bin" // optional, generated by tools/mkbootbin
+#define CONFIG_DEFAULT_BOOT_CMD	 "console=ttyS2,115200 earlycon"
+#define CONFIG_BOOT_MAX_TRIES	 2
+
+// Boot media for a plain build of this file, each Makefile variant sets its own
+// #define CONFIG_BOOT_SPINAND
+// #define CONFIG_BOOT_SPINOR
+#define CONFIG_BOOT_SDCARD
+// #define CONFIG_BOOT_MMC
+
+// #define CONFIG_ENABLE_CPU_FREQ_DUMP
+
+// #define CONFIG_DMA_MEMCPY_BENCH
+
+// #define CONFIG_DRAM_MEMTEST	  MEMTEST_ALL
+#define CONFIG_DRAM_MEMTEST_MB 1 // coverage from SDRAM_BASE, 0 for the full size
+
+#define CONFIG_SPINAND_DTB_ADDR	   (128 * 2048)
+#define CONFIG_SPINAND_KERNEL_ADDR (256 * 2048)
+
+#define CONFIG_SPINOR_DTB_ADDR	  (64 * 1024)
+#define CONFIG_SPINOR_KERNEL_ADDR (256 * 1024)
+
+#define LED_BOARD  1
+#define LED_BUTTON 2
+
+extern const dram_profile_t dram_profiles[];
+extern const unsigned int	dram_profile_count;
+extern sunxi_usart_t		USART_DBG;
+extern sunxi_spi_t			sunxi_spi0;
+
+void board_init(void);
+void board_set_led(uint8_t num, uint8_t on);
+bool board_get_button(void);
+void board_set_status(bool on);
+bool board_get_power_on(void);
+int	 board_get_dram_profile(void);
+
+#endif
@@ -30,6 +30,8 @@ sunxi_spi_t sunxi_spi0 = {
 	.gpio_miso = {GPIO_PIN(PORTC, 5), GPIO_PERIPH_MUX2},
 	.gpio_wp   = {GPIO_PIN(PORTC, 6), GPIO_PERIPH_MUX2},
 	.gpio_hold = {GPIO_PIN(PORTC, 7), GPIO_PERIPH_MUX2},
+	.dma_width = 4,
+	.dma_burst = 8,
 };
 
 sdhci_t sdhci0 = {
@@ -48,6 +50,25 @@ sdhci_t sdhci0 = {
 	.gpio_d3   = {GPIO_PIN(PORTF, 4), GPIO_PERIPH_MUX2},
 };
 
+#define DRAM_PARA_DDR3(clk)                                                                                           \
+	{                                                                                                                  \
+		.dram_clk = (clk), .dram_type = SUNXI_DRAM_TYPE_DDR3, .dram_zq = 0x7b7bfb, .dram_odt_en = 0x00,                \
+		.dram_para1 = 0x000010d2, .dram_para2 = 0, .dram_mr0 = 0x1c70, .dram_mr1 = 0x42, .dram_mr2 = 0x18,             \
+		.dram_mr3 = 0, .dram_tpr0 = 0x004a2195, .dram_tpr1 = 0x02423190, .dram_tpr2 = 0x0008b061,                      \
+		.dram_tpr3 = 0xb4787896, .dram_tpr4 = 0, .dram_tpr5 = 0x48484848, .dram_tpr6 = 0x00000048,                     \
+		.dram_tpr7 = 0x1620121e, .dram_tpr8 = 0, .dram_tpr9 = 0, .dram_tpr10 = 0, .dram_tpr11 = 0x00340000,            \
+		.dram_tpr12 = 0x00000046, .dram_tpr13 = 0x34000100,                                                            \
+	}
+
+// Tried in order until one passes, the timings are derived from dram_clk.
+// Profiles above the SoC's dram_clk_max (soc.h) are skipped.
+const dram_profile_t dram_profiles[] = {
+	{"ddr3-936", DRAM_PARA_DDR3(936)}, // T113-S4
+	{"ddr3-792", DRAM_PARA_DDR3(792)},
+	{"ddr3-672", DRAM_PARA_DDR3(672)}, // margin for slower parts
+};
+const unsigned int dram_profile_count = ARRAY_SIZE(dram_profiles);
+
 static const gpio_t led_board = GPIO_PIN(PORTD, 18);
 static const gpio_t led_btn	  = GPIO_PIN(PORTB, 5);
 static const gpio_t btn		  = GPIO_PIN(PORTE, 9);
@@ -101,6 +122,12 @@ void board_set_status(bool on)
 	sunxi_gpio_write(status, on);
 }
 
+// Index in dram_profiles[] from a strap or the SID, -1 to try them in order
+int board_get_dram_profile(void)
+{
+	return -1;
+}
+
 void board_init()
 {
 	output_init(led_board);
@@ -7,6 +7,20 @@
 
 typedef unsigned int virtual_addr_t;
 
+#ifdef CONFIG_IO_MODEL
+/* Host builds route the accesses to a register model, see tools/regsim */
+uint64_t io_model_read(virtual_addr_t addr, unsigned int width);
+void	 io_model_write(virtual_addr_t addr, uint64_t value, unsigned int width);
+
+#define read8(addr)				((uint8_t)io_model_read((addr), 8))
+#define read16(addr)			((uint16_t)io_model_read((addr), 16))
+#define read32(addr)			((uint32_t)io_model_read((addr), 32))
+#define read64(addr)			io_model_read((addr), 64)
+#define write8(addr, value)		io_model_write((addr), (value), 8)
+#define write16(addr, value)	io_model_write((addr), (value), 16)
+#define write32(addr, value)	io_model_write((addr), (value), 32)
+#define write64(addr, value)	io_model_write((addr), (value), 64)
+#else
 static inline __attribute__((__always_inline__)) uint8_t read8(virtual_addr_t addr)
 {
 	return (*((volatile uint8_t *)(addr)));
@@ -47,4 +61,6 @@ static inline __attribute__((__always_inline__)) void write64(virtual_addr_t add
 	*((volatile uint64_t *)(addr)) = value;
 }
 
-#endif
\ No newline at end of file
+#endif /* CONFIG_IO_MODEL */
+
+#endif
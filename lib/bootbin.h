@@ -0,0 +1,55 @@
+#ifndef __BOOTBIN_H__
+#define __BOOTBIN_H__
+
+/* Binary boot configuration, one sector holding what boot.cfg, the
+ * .state and the slot .cfg files describe. Shared with tools/mkbootbin.
+ * All fields are little endian.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BOOTBIN_MAGIC	0x43425741 // "AWBC"
+#define BOOTBIN_VERSION 1
+#define BOOTBIN_SIZE	512
+#define BOOTBIN_SLOTS	3 // R, A, B
+
+#define BOOTBIN_STATE_BAD  0
+#define BOOTBIN_STATE_GOOD 1
+
+typedef struct {
+	// Offsets of NUL terminated strings in the sector, 0 when unset
+	uint16_t kernel;
+	uint16_t dtb;
+	uint16_t initrd;
+	uint16_t args;
+	uint16_t overlays;
+	uint8_t	 state;
+	uint8_t	 root_part;
+} bootbin_slot_t;
+
+typedef struct {
+	uint32_t	   magic;
+	uint8_t		   version;
+	uint8_t		   active; // 'R', 'A' or 'B'
+	uint16_t	   reserved;
+	uint32_t	   crc; // CRC-32 of the sector with this field zeroed
+	bootbin_slot_t slots[BOOTBIN_SLOTS];
+} bootbin_header_t;
+
+static inline uint32_t bootbin_crc32(uint32_t crc, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	int			   bit;
+
+	crc = ~crc;
+	while (len--) {
+		crc ^= *p++;
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+	}
+
+	return ~crc;
+}
+
+#endif
@@ -1,30 +1,209 @@
 #include "bootconf.h"
+#include "bootbin.h"
 #include "loaders.h"
 
-static char boot_cfg_buffer[512];
+// Holds the binary config for the whole boot when it was loaded
+static char boot_cfg_buffer[BOOTBIN_SIZE] __attribute__((aligned(4)));
+static bool boot_bin_loaded;
 
-// Copy value without line ending chars or leading spaces
-static void val_copy(char *dst, const char *src, uint32_t maxlen)
+static int bin_slot_index(char name)
 {
-	// Trim var name
-	while (*src != '=') {
-		src++;
+	switch (name) {
+		case 'R':
+			return 0;
+		case 'A':
+			return 1;
+		case 'B':
+			return 2;
+		default:
+			return -1;
 	}
-	// Move right after the =
-	src++;
-	// Trim more spaces
-	while (*src == ' ' || *src == '\t') {
-		src++;
+}
+
+static int bin_copy_string(char *dst, uint16_t offset, uint32_t size)
+{
+	*dst = '\0';
+	if (!offset)
+		return 0;
+	if (offset < sizeof(bootbin_header_t) || offset >= BOOTBIN_SIZE)
+		return -1;
+	if (!memchr(&boot_cfg_buffer[offset], '\0', min(size, BOOTBIN_SIZE - offset)))
+		return -1;
+
+	strcpy(dst, &boot_cfg_buffer[offset]);
+
+	return 0;
+}
+
+/*
+  Load and check the binary config, the text files are used when this fails
+*/
+bool bootconf_load_bin(const char *filename)
+{
+	bootbin_header_t *hdr = (bootbin_header_t *)boot_cfg_buffer;
+	uint32_t		  crc;
+	int				  bytes_read;
+
+	boot_bin_loaded = false;
+
+	bytes_read = read_file_max(filename, (BYTE *)boot_cfg_buffer, BOOTBIN_SIZE);
+	if (bytes_read <= 0) {
+		debug("BOOT: no %s, using text config\r\n", filename);
+		return false;
 	}
 
-	while (maxlen--) {
-		if (*src == '\r' || *src == '\n') {
-			break;
+	if (bytes_read != BOOTBIN_SIZE || hdr->magic != BOOTBIN_MAGIC || hdr->version != BOOTBIN_VERSION) {
+		error("BOOT: invalid %s, using text config\r\n", filename);
+		return false;
+	}
+
+	crc		 = hdr->crc;
+	hdr->crc = 0;
+	if (bootbin_crc32(0, boot_cfg_buffer, BOOTBIN_SIZE) != crc) {
+		error("BOOT: bad CRC in %s, using text config\r\n", filename);
+		return false;
+	}
+	hdr->crc = crc;
+
+	info("BOOT: using %s\r\n", filename);
+	boot_bin_loaded = true;
+
+	return true;
+}
+
+/* Text config files
+ * One key=value per line, or a bare word. Blank lines and lines starting
+ * with # are skipped, values may be double quoted to keep leading or
+ * trailing spaces. The file is parsed in place within its length.
+ */
+typedef struct {
+	const char	*filename;
+	const char	*buf;
+	unsigned int len;
+	unsigned int pos;
+	unsigned int line;
+
+	const char	*key;
+	unsigned int key_len;
+	const char	*value; // NULL for a bare word
+	unsigned int value_len;
+} conf_parser_t;
+
+static inline bool conf_is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static int conf_open(conf_parser_t *conf, const char *filename)
+{
+	int bytes_read;
+
+	bytes_read = read_file_max(filename, (BYTE *)boot_cfg_buffer, sizeof(boot_cfg_buffer));
+	if (bytes_read <= 0)
+		return -1;
+
+	memset(conf, 0, sizeof(conf_parser_t));
+	conf->filename = filename;
+	conf->buf	   = boot_cfg_buffer;
+	conf->len	   = bytes_read;
+
+	return 0;
+}
+
+// Move to the next key, false at the end of the file
+static bool conf_next(conf_parser_t *conf)
+{
+	const char	*buf = conf->buf;
+	unsigned int start, end, eol;
+
+	while (conf->pos < conf->len) {
+		conf->line++;
+
+		start = conf->pos;
+		for (eol = start; eol < conf->len && buf[eol] != '\n'; eol++)
+			;
+		conf->pos = eol + 1;
+
+		for (end = eol; end > start && conf_is_space(buf[end - 1]); end--)
+			;
+		while (start < end && conf_is_space(buf[start]))
+			start++;
+		if (start == end || buf[start] == '#')
+			continue;
+
+		conf->key = &buf[start];
+		while (start < end && buf[start] != '=' && !conf_is_space(buf[start]))
+			start++;
+		conf->key_len = &buf[start] - conf->key;
+		while (start < end && conf_is_space(buf[start]))
+			start++;
+
+		conf->value		= NULL;
+		conf->value_len = 0;
+		if (start == end)
+			return true;
+
+		if (buf[start++] != '=') {
+			warning("BOOT: %s:%u: expected '='\r\n", conf->filename, conf->line);
+			continue;
+		}
+		while (start < end && conf_is_space(buf[start]))
+			start++;
+
+		if (start < end && buf[start] == '"') {
+			for (eol = ++start; eol < end && buf[eol] != '"'; eol++)
+				;
+			if (eol == end) {
+				warning("BOOT: %s:%u: missing '\"'\r\n", conf->filename, conf->line);
+				continue;
+			}
+			end = eol;
 		}
-		*dst++ = *src++;
+
+		conf->value		= &buf[start];
+		conf->value_len = end - start;
+
+		return true;
 	}
-	if (maxlen)
-		*dst = '\0';
+
+	return false;
+}
+
+static bool conf_key_is(const conf_parser_t *conf, const char *key)
+{
+	return conf->key_len == strlen(key) && !strncmp(conf->key, key, conf->key_len);
+}
+
+static bool conf_copy(const conf_parser_t *conf, char *dst, uint32_t size)
+{
+	if (!conf->value || conf->value_len >= size) {
+		error("BOOT: %s:%u: value missing or longer than %u\r\n", conf->filename, conf->line, size - 1);
+		return false;
+	}
+
+	memcpy(dst, conf->value, conf->value_len);
+	dst[conf->value_len] = '\0';
+
+	return true;
+}
+
+static bool conf_number(const conf_parser_t *conf, uint32_t max, uint32_t *num)
+{
+	unsigned int i;
+
+	*num = 0;
+	for (i = 0; conf->value && i < conf->value_len; i++) {
+		if (conf->value[i] < '0' || conf->value[i] > '9' || *num > max / 10)
+			break;
+		*num = *num * 10 + conf->value[i] - '0';
+	}
+
+	if (!conf->value_len || i != conf->value_len || *num > max) {
+		error("BOOT: %s:%u: invalid number\r\n", conf->filename, conf->line);
+		return false;
+	}
+
+	return true;
 }
 
 /*
@@ -32,38 +211,28 @@ static void val_copy(char *dst, const char *src, uint32_t maxlen)
 */
 char bootconf_get_slot(const char *filename)
 {
-	int	  bytes_read;
-	char *line_start;
-	char  name = '?';
+	conf_parser_t conf;
+	char		  name = '?';
 
-	bytes_read = read_file(filename, (BYTE *)boot_cfg_buffer);
+	if (boot_bin_loaded) {
+		name = ((bootbin_header_t *)boot_cfg_buffer)->active;
+		if (bin_slot_index(name) < 0) {
+			error("BOOT: slot not found\r\n");
+			name = 'R';
+		}
+		return name;
+	}
 
-	if (bytes_read <= 0) {
+	if (conf_open(&conf, filename) != 0) {
 		error("BOOT: Missing or empty %s file\r\n", filename);
 		return 'R';
 	}
 
-	line_start = boot_cfg_buffer;
-
-	while (line_start != NULL && *line_start != '\0' && (line_start - boot_cfg_buffer) <= bytes_read) {
-		while (*line_start == ' ')
-			line_start++;
-
-		// Commented or empty lines
-		if (*line_start == '#' || *line_start == '\n') {
-			line_start = strchr(line_start, '\n');
-			if (line_start)
-				line_start++;
-			continue;
-		}
-
-		if (strncmp(line_start, "slot", sizeof("slot") - 1) == 0) {
-			val_copy(&name, line_start, 1);
+	while (conf_next(&conf)) {
+		if (conf_key_is(&conf, "slot") && conf.value_len == 1) {
+			name = conf.value[0];
 			break;
 		}
-		line_start = strchr(line_start, '\n');
-		if (line_start)
-			line_start++;
 	}
 	// Slot name not found, use recovery
 	if (name == '?') {
@@ -76,42 +245,29 @@ char bootconf_get_slot(const char *filename)
 
 /*
   Read state file to know if slot is marked bad
-  Return true (slot good) is missing/empty
+  Return false (slot bad) if missing/empty
 */
 bool bootconf_is_slot_state_good(const char *filename)
 {
-	int	  bytes_read;
-	char *line_start;
+	conf_parser_t conf;
+	int			  index;
 
-	bytes_read = read_file(filename, (BYTE *)boot_cfg_buffer);
+	if (boot_bin_loaded) {
+		index = bin_slot_index(filename[0]);
+		return index >= 0 && ((bootbin_header_t *)boot_cfg_buffer)->slots[index].state == BOOTBIN_STATE_GOOD;
+	}
 
-	if (bytes_read <= 0) {
+	if (conf_open(&conf, filename) != 0) {
 		error("BOOT: Missing or empty %s file\r\n", filename);
 		return false;
 	}
 
-	line_start = boot_cfg_buffer;
-
-	while (line_start != NULL && *line_start != '\0' && (line_start - boot_cfg_buffer) <= bytes_read) {
-		while (*line_start == ' ')
-			line_start++;
-
-		// Commented or empty lines
-		if (*line_start == '#' || *line_start == '\n') {
-			line_start = strchr(line_start, '\n');
-			if (line_start)
-				line_start++;
-			continue;
-		}
-
-		if (strncmp(line_start, "bad", sizeof("bad") - 1) == 0) {
+	while (conf_next(&conf)) {
+		if (conf_key_is(&conf, "bad")) {
 			return false;
-		} else if (strncmp(line_start, "good", sizeof("good") - 1) == 0) {
+		} else if (conf_key_is(&conf, "good")) {
 			return true;
 		}
-		line_start = strchr(line_start, '\n');
-		if (line_start)
-			line_start++;
 	}
 
 	return false;
@@ -119,45 +275,61 @@ bool bootconf_is_slot_state_good(const char *filename)
 
 uint8_t bootconf_load_slot_data(const char *filename, slot_t *slot)
 {
-	int	  bytes_read;
-	char *line_start;
+	conf_parser_t conf;
+	uint32_t	  num;
+	bool		  ok = true;
 
 	memset(slot, 0, sizeof(slot_t));
 
-	bytes_read = read_file(filename, (BYTE *)boot_cfg_buffer);
+	if (boot_bin_loaded) {
+		const bootbin_slot_t *bin;
+		int					  index = bin_slot_index(filename[0]);
 
-	if (bytes_read <= 0) {
-		return 1;
-	}
+		if (index < 0)
+			return 1;
+		bin = &((bootbin_header_t *)boot_cfg_buffer)->slots[index];
+		if (!bin->kernel || bin_copy_string(slot->kernel_filename, bin->kernel, MAX_FILENAME_SIZE) ||
+			bin_copy_string(slot->dtb_filename, bin->dtb, MAX_FILENAME_SIZE) ||
+			bin_copy_string(slot->initrd_filename, bin->initrd, MAX_FILENAME_SIZE) ||
+			bin_copy_string(slot->kernel_cmd, bin->args, MAX_CMD_SIZE) ||
+			bin_copy_string(slot->overlays, bin->overlays, MAX_CMD_SIZE)) {
+			error("BOOT: invalid slot %c in binary config\r\n", filename[0]);
+			return 1;
+		}
+		slot->root_part = bin->root_part;
 
-	line_start = boot_cfg_buffer;
+		return 0;
+	}
 
-	while (line_start != NULL && *line_start != '\0' && (line_start - boot_cfg_buffer) <= bytes_read) {
-		while (*line_start == ' ')
-			line_start++;
+	if (conf_open(&conf, filename) != 0) {
+		return 1;
+	}
 
-		// Commented or empty lines
-		if (*line_start == '#' || *line_start == '\n') {
-			line_start = strchr(line_start, '\n');
-			if (line_start)
-				line_start++;
-			continue;
+	// A bad value fails the slot as in the binary config, it must not boot half set
+	while (conf_next(&conf)) {
+		if (conf_key_is(&conf, "kernel")) {
+			ok = conf_copy(&conf, slot->kernel_filename, MAX_FILENAME_SIZE);
+		} else if (conf_key_is(&conf, "dtb")) {
+			ok = conf_copy(&conf, slot->dtb_filename, MAX_FILENAME_SIZE);
+		} else if (conf_key_is(&conf, "initrd")) {
+			ok = conf_copy(&conf, slot->initrd_filename, MAX_FILENAME_SIZE);
+		} else if (conf_key_is(&conf, "args")) {
+			ok = conf_copy(&conf, slot->kernel_cmd, MAX_CMD_SIZE);
+		} else if (conf_key_is(&conf, "overlays")) {
+			ok = conf_copy(&conf, slot->overlays, MAX_CMD_SIZE);
+		} else if (conf_key_is(&conf, "rootpart")) {
+			ok = conf_number(&conf, 255, &num);
+			if (ok)
+				slot->root_part = num;
+		} else {
+			debug("BOOT: %s:%u: unknown key\r\n", filename, conf.line);
 		}
 
-		if (strncmp(line_start, "kernel", sizeof("kernel") - 1) == 0) {
-			val_copy(slot->kernel_filename, line_start, MAX_FILENAME_SIZE);
-		} else if (strncmp(line_start, "dtb", sizeof("dtb") - 1) == 0) {
-			val_copy(slot->dtb_filename, line_start, MAX_FILENAME_SIZE);
-		} else if (strncmp(line_start, "initrd", sizeof("initrd") - 1) == 0) {
-			val_copy(slot->initrd_filename, line_start, MAX_FILENAME_SIZE);
-		} else if (strncmp(line_start, "args", sizeof("args") - 1) == 0) {
-			val_copy(slot->kernel_cmd, line_start, MAX_CMD_SIZE);
+		if (!ok) {
+			error("BOOT: invalid slot config %s\r\n", filename);
+			return 1;
 		}
-
-		line_start = strchr(line_start, '\n');
-		if (line_start)
-			line_start++;
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -9,10 +9,13 @@ typedef struct {
 	char	 kernel_filename[MAX_FILENAME_SIZE];
 	char	 initrd_filename[MAX_FILENAME_SIZE];
 	char	 kernel_cmd[MAX_CMD_SIZE];
+	char	 overlays[MAX_CMD_SIZE]; // .dtbo files separated by spaces or commas
+	uint8_t	 root_part;				 // partition number for ${root_partuuid}, 0 if none
 	uint32_t initrd_start;
 	uint32_t initrd_end;
 } slot_t;
 
+bool	bootconf_load_bin(const char *filename);
 char	bootconf_get_slot(const char *filename);
 bool	bootconf_is_slot_state_good(const char *filename);
 uint8_t bootconf_load_slot_data(const char *filename, slot_t *slot);
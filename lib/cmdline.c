@@ -0,0 +1,153 @@
+#include "cmdline.h"
+#include "xformat.h"
+
+typedef struct {
+	char		*buf;
+	unsigned int len;
+	unsigned int size;
+} cmdline_out_t;
+
+static void cmdline_putc(void *arg, char c)
+{
+	cmdline_out_t *out = arg;
+
+	if (out->len < out->size)
+		out->buf[out->len] = c;
+	out->len++;
+}
+
+void cmdline_init(cmdline_t *cmd, char *arena, unsigned int size)
+{
+	memset(cmd, 0, sizeof(cmdline_t));
+	cmd->buf   = arena;
+	cmd->size  = size;
+	cmd->limit = size;
+	if (size)
+		cmd->buf[0] = '\0';
+}
+
+/* The value is formatted in the free space first, then moved below the others */
+int cmdline_set_var(cmdline_t *cmd, const char *name, const char *fmt, ...)
+{
+	cmdline_out_t out;
+	va_list		  args;
+	unsigned int  i;
+
+	if (cmd->limit < cmd->len + 2) {
+		error("CMDLINE: no room for ${%s}\r\n", name);
+		return -1;
+	}
+
+	out.buf	 = cmd->buf + cmd->len + 1;
+	out.len	 = 0;
+	out.size = cmd->limit - cmd->len - 1;
+
+	va_start(args, fmt);
+	xvformat(cmdline_putc, &out, fmt, args);
+	va_end(args);
+
+	if (out.len >= out.size) {
+		error("CMDLINE: no room for ${%s}\r\n", name);
+		return -1;
+	}
+
+	cmd->limit -= out.len + 1;
+	memmove(cmd->buf + cmd->limit, out.buf, out.len);
+	cmd->buf[cmd->limit + out.len] = '\0';
+
+	for (i = 0; i < cmd->count; i++) {
+		if (!strcmp(cmd->vars[i].name, name))
+			break;
+	}
+	if (i == CMDLINE_MAX_VARS) {
+		error("CMDLINE: too many variables\r\n");
+		return -1;
+	}
+	if (i == cmd->count)
+		cmd->count++;
+
+	cmd->vars[i].name  = name;
+	cmd->vars[i].value = cmd->buf + cmd->limit;
+	trace("CMDLINE: ${%s} = %s\r\n", name, cmd->vars[i].value);
+
+	return 0;
+}
+
+static const char *cmdline_get_var(cmdline_t *cmd, const char *name, unsigned int len)
+{
+	unsigned int i;
+
+	for (i = 0; i < cmd->count; i++) {
+		if (!strncmp(cmd->vars[i].name, name, len) && cmd->vars[i].name[len] == '\0')
+			return cmd->vars[i].value;
+	}
+
+	return NULL;
+}
+
+static int cmdline_put(cmdline_t *cmd, const char *s, unsigned int len, unsigned int max)
+{
+	if (cmd->len + len > max)
+		return -1;
+
+	memcpy(cmd->buf + cmd->len, s, len);
+	cmd->len += len;
+
+	return 0;
+}
+
+/* Append args after a space, ${name} is replaced with the variable value.
+ * Nothing is added when the result does not fit.
+ */
+int cmdline_append(cmdline_t *cmd, const char *args)
+{
+	unsigned int start = cmd->len;
+	unsigned int max   = min(cmd->limit, CMDLINE_MAX_SIZE) - 1;
+	const char	*end, *value;
+
+	while (*args == ' ' || *args == '\t')
+		args++;
+	if (*args == '\0')
+		return 0;
+
+	if (cmd->len && cmdline_put(cmd, " ", 1, max))
+		goto overflow;
+
+	while (*args) {
+		end = strchr(args, '$');
+		if (!end)
+			end = args + strlen(args);
+
+		if (cmdline_put(cmd, args, end - args, max))
+			goto overflow;
+		args = end;
+		if (*args == '\0')
+			break;
+
+		end = strchr(args, '}');
+		if (args[1] != '{' || !end) {
+			if (cmdline_put(cmd, args++, 1, max))
+				goto overflow;
+			continue;
+		}
+
+		value = cmdline_get_var(cmd, args + 2, end - args - 2);
+		if (!value) {
+			warning("CMDLINE: unknown variable in %s\r\n", args);
+		} else if (cmdline_put(cmd, value, strlen(value), max)) {
+			goto overflow;
+		}
+		args = end + 1;
+	}
+
+	cmd->buf[cmd->len] = '\0';
+
+	return 0;
+
+overflow:
+	error("CMDLINE: arguments do not fit in %u bytes\r\n", max + 1);
+	cmd->len		   = start;
+	cmd->buf[cmd->len] = '\0';
+
+	return -1;
+}
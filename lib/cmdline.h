@@ -0,0 +1,31 @@
+#ifndef __CMDLINE_H__
+#define __CMDLINE_H__
+
+#include "common.h"
+
+// COMMAND_LINE_SIZE of the arm kernel, terminator included
+#define CMDLINE_MAX_SIZE 1024
+#define CMDLINE_MAX_VARS 8
+
+typedef struct {
+	const char *name;
+	const char *value;
+} cmdline_var_t;
+
+/* The command line grows up from the start of the arena,
+ * variable values are stored down from its end.
+ */
+typedef struct {
+	char		 *buf;
+	unsigned int  size;
+	unsigned int  len;
+	unsigned int  limit; // first byte used by the values
+	cmdline_var_t vars[CMDLINE_MAX_VARS];
+	unsigned int  count;
+} cmdline_t;
+
+void cmdline_init(cmdline_t *cmd, char *arena, unsigned int size);
+int	 cmdline_set_var(cmdline_t *cmd, const char *name, const char *fmt, ...);
+int	 cmdline_append(cmdline_t *cmd, const char *args);
+
+#endif
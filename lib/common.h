@@ -51,9 +51,13 @@ typedef struct {
 	unsigned char *initrd_dest;
 	unsigned int   initrd_size;
 
+	unsigned char *overlay_dest; // loaded back to back, 8 bytes aligned
+	unsigned int   overlay_count;
+
 	char *filename;
 	char *dtb_filename;
 	char *initrd_filename;
+	char *overlays;
 } image_info_t;
 
 /* Linux zImage Header */
@@ -3,10 +3,58 @@
 #include "common.h"
 #include "board.h"
 
+#ifndef CONFIG_LOG_BUFFER_SIZE
+#define CONFIG_LOG_BUFFER_SIZE 2048
+#endif
+
+#if (CONFIG_LOG_BUFFER_SIZE & (CONFIG_LOG_BUFFER_SIZE - 1))
+#error "CONFIG_LOG_BUFFER_SIZE must be a power of two"
+#endif
+
+/* Messages are queued here and sent when the UART FIFO has room,
+ * head and tail are free running and masked on access.
+ */
+static char		log_buffer[CONFIG_LOG_BUFFER_SIZE];
+static uint32_t log_head;
+static uint32_t log_tail;
+
+void log_poll(void)
+{
+	uint32_t tail, len;
+
+	while (log_tail != log_head) {
+		tail = log_tail & (CONFIG_LOG_BUFFER_SIZE - 1);
+		len	 = min(log_head - log_tail, CONFIG_LOG_BUFFER_SIZE - tail);
+		len	 = sunxi_usart_put_nb(&USART_DBG, &log_buffer[tail], len);
+		if (!len)
+			break;
+		log_tail += len;
+	}
+}
+
+void log_flush(void)
+{
+	while (log_tail != log_head)
+		log_poll();
+
+	sunxi_usart_wait_tx(&USART_DBG);
+}
+
+static void log_putc(void *arg, char c)
+{
+	// Full, wait for the UART rather than dropping output
+	while (log_head - log_tail >= CONFIG_LOG_BUFFER_SIZE)
+		log_poll();
+
+	log_buffer[log_head++ & (CONFIG_LOG_BUFFER_SIZE - 1)] = c;
+}
+
 void message(const char *fmt, ...)
 {
 	va_list args;
 	va_start(args, fmt);
-	xvformat(sunxi_usart_putc, &USART_DBG, fmt, args);
+	xvformat(log_putc, NULL, fmt, args);
 	va_end(args);
+
+	log_poll();
 }
@@ -54,10 +54,16 @@
 	{                                                                 \
 		sunxi_wdg_set(1);                                             \
 		message("[F] " fmt "restarting in 1s...\r\n", ##__VA_ARGS__); \
+		log_flush();                                                  \
 		while (1) {                                                   \
 		};                                                            \
 	}
 
 void __attribute__((format(printf, 1, 2))) message(const char *fmt, ...);
 
+// Send some queued output without waiting, called from delay loops
+void log_poll(void);
+// Send all queued output, before a jump or a hang
+void log_flush(void);
+
 #endif
@@ -33,6 +33,26 @@ static BYTE cache_pdrv = -1;
 
 #define CACHE_IS_VALID(ss)	({ __typeof(ss) _ss = (ss); cache_bitmap[CACHE_SECTOR_TO_OFFSET(_ss)] & (1 << CACHE_SECTOR_TO_BIT(_ss)); })
 #define CACHE_SET_VALID(ss)	do { __typeof(ss) _ss = (ss); cache_bitmap[CACHE_SECTOR_TO_OFFSET(_ss)] |= (1 << CACHE_SECTOR_TO_BIT(_ss)); } while(0)
+
+/* Cache to FatFs buffer copies run on the DMA while the next chunk is read from the card */
+typedef struct {
+	u32			hdma;
+	void	   *dst;
+	const void *src;
+	u32			len;
+} fatfs_cache_copy_t;
+
+static void fatfs_cache_copy_wait(fatfs_cache_copy_t *copy)
+{
+	if (copy->hdma) {
+		/* the source chunk stays in the cache, redo it on the CPU as dma_memcpy() does */
+		if (dma_memcpy_wait(copy->hdma) != 0) {
+			warning("FATFS: cache copy DMA failed\r\n");
+			memcpy(copy->dst, copy->src, copy->len);
+		}
+		copy->hdma = 0;
+	}
+}
 #endif
 
 /*-----------------------------------------------------------------------*/
@@ -73,6 +93,11 @@ DRESULT disk_read(BYTE	pdrv, /* Physical drive nmuber to identify the drive */
 				  UINT	count /* Number of sectors to read */
 )
 {
+#ifdef CONFIG_FATFS_CACHE_SIZE
+	fatfs_cache_copy_t copy = {0};
+	UINT n;
+#endif
+
 	if (pdrv || !count)
 		return RES_PARERR;
 	if (Stat & STA_NOINIT)
@@ -91,6 +116,7 @@ DRESULT disk_read(BYTE	pdrv, /* Physical drive nmuber to identify the drive */
 	while (count) {
 		if (sector >= FATFS_CACHE_SECTORS) {
 			trace("FATFS: beyond cache %llu count %u\r\n", sector, count);
+			fatfs_cache_copy_wait(&copy);
 			/* beyond end of cache, read remaining */
 			if (sdmmc_blk_read(&card0, buff, sector, count) != count) {
 				warning("FATFS: read failed %llu count %u\r\n", sector, count);
@@ -102,8 +128,10 @@ DRESULT disk_read(BYTE	pdrv, /* Physical drive nmuber to identify the drive */
 		if (!CACHE_IS_VALID(sector)) {
 			LBA_t chunk = sector & ~(FATFS_CACHE_SECTORS_PER_BIT-1);
 			trace("FATFS: cache miss %llu, loading %llu count %u\r\n", sector, chunk, FATFS_CACHE_SECTORS_PER_BIT);
+			/* the copy of the previous chunk keeps running meanwhile */
 			if (sdmmc_blk_read(&card0, &cache_data[chunk*FF_MIN_SS], chunk, FATFS_CACHE_SECTORS_PER_BIT) != FATFS_CACHE_SECTORS_PER_BIT) {
 				warning("FATFS: read failed %llu count %u\r\n", sector, FATFS_CACHE_SECTORS_PER_BIT);
+				fatfs_cache_copy_wait(&copy);
 				return RES_ERROR;
 			}
 			CACHE_SET_VALID(sector);
@@ -111,12 +139,26 @@ DRESULT disk_read(BYTE	pdrv, /* Physical drive nmuber to identify the drive */
 		else {
 			trace("FATFS: cache hit %llu\r\n", sector);
 		}
-		memcpy(buff, &cache_data[sector*FF_MIN_SS], FF_MIN_SS);
 
-		sector++;
-		buff += FF_MIN_SS;
-		count--;
+		/* copy everything this chunk holds in one go */
+		n = FATFS_CACHE_SECTORS_PER_BIT - (sector % FATFS_CACHE_SECTORS_PER_BIT);
+		if (n > count)
+			n = count;
+
+		fatfs_cache_copy_wait(&copy);
+		copy.dst = buff;
+		copy.src = &cache_data[sector*FF_MIN_SS];
+		copy.len = n * FF_MIN_SS;
+		if (copy.len >= DMA_MEMCPY_MIN_SIZE)
+			copy.hdma = dma_memcpy_async(copy.dst, copy.src, copy.len);
+		if (!copy.hdma)
+			memcpy(copy.dst, copy.src, copy.len);
+
+		sector += n;
+		buff += n * FF_MIN_SS;
+		count -= n;
 	}
+	fatfs_cache_copy_wait(&copy);
 	return RES_OK;
 #else
 	return (sdmmc_blk_read(&card0, buff, sector, count) == count ? RES_OK : RES_ERROR);
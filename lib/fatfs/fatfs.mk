@@ -2,12 +2,12 @@ FS_FAT := lib/fatfs
 
 INCLUDE_DIRS += -I $(FS_FAT)
 
-USE_FAT = $(shell grep -E "^\#define CONFIG_BOOT_(SDCARD|MMC)" board.h)
-
-ifneq ($(USE_FAT),)
-SRCS	+=  $(FS_FAT)/ff.c
-SRCS	+=  $(FS_FAT)/diskio.c
-SRCS	+=  $(FS_FAT)/ffsystem.c
-SRCS	+=  $(FS_FAT)/ffunicode.c
-
-endif
+SDMMC_SRCS	+=  $(FS_FAT)/ff.c
+SDMMC_SRCS	+=  $(FS_FAT)/diskio.c
+SDMMC_SRCS	+=  $(FS_FAT)/ffsystem.c
+SDMMC_SRCS	+=  $(FS_FAT)/ffunicode.c
+
+# diskio.c stays in SRAM with its sector cache bitmap
+DRAM_SRCS	+=  $(FS_FAT)/ff.c
+DRAM_SRCS	+=  $(FS_FAT)/ffsystem.c
+DRAM_SRCS	+=  $(FS_FAT)/ffunicode.c
@@ -679,6 +679,25 @@ static const BYTE DbcTbl[] = MKCVTBL(TBL_DC, FF_CODE_PAGE);
 
 #endif
 
+#if FF_USE_LFN && FF_ASCII_ONLY /* ASCII only names in place of ffunicode.c */
+static inline WCHAR ff_oem2uni(WCHAR oem, WORD cp)
+{
+	(void)cp;
+	return oem < 0x80 ? oem : 0; /* Extended characters are invalid */
+}
+
+static inline WCHAR ff_uni2oem(DWORD uni, WORD cp)
+{
+	(void)cp;
+	return uni < 0x80 ? (WCHAR)uni : 0;
+}
+
+static inline DWORD ff_wtoupper(DWORD uni)
+{
+	return IsLower(uni) ? uni - 0x20 : uni;
+}
+#endif
+
 /*--------------------------------------------------------------------------
 
    Module Private Functions
@@ -335,7 +335,7 @@ DWORD get_fattime(void); /* Get current time */
 
 /* LFN support functions (defined in ffunicode.c) */
 
-#if FF_USE_LFN >= 1
+#if FF_USE_LFN >= 1 && !FF_ASCII_ONLY
 WCHAR ff_oem2uni(WCHAR oem, WORD cp); /* OEM code to Unicode conversion */
 WCHAR ff_uni2oem(DWORD uni, WORD cp); /* Unicode to OEM code conversion */
 DWORD ff_wtoupper(DWORD uni); /* Unicode upper-case conversion */
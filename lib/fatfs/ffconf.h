@@ -132,6 +132,17 @@
 /  Also behavior of string I/O functions will be affected by this option.
 /  When LFN is not enabled, this option has no effect. */
 
+#define FF_ASCII_ONLY 1
+/* This option limits the LFN to ASCII characters when LFN is enabled.
+/
+/   0: Full Unicode support with the conversion tables of ffunicode.c.
+/   1: ASCII only. ffunicode.c is blanked and only a-z are up-cased, inline.
+/      Other characters of a LFN are matched case sensitively and short names
+/      with extended characters can not be converted.
+/
+/  The boot files have known ASCII names, this drops the code page and up-case
+/  tables from the image. On exFAT the name hash of an ASCII name is the same. */
+
 #define FF_LFN_BUF 255
 #define FF_SFN_BUF 12
 /* This set of options defines size of file name members in the FILINFO structure
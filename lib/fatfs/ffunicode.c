@@ -24,7 +24,7 @@
 
 #include "ff.h"
 
-#if FF_USE_LFN != 0 /* This module will be blanked if in non-LFN configuration */
+#if FF_USE_LFN != 0 && !FF_ASCII_ONLY /* This module will be blanked if in non-LFN or ASCII only configuration */
 
 #define MERGE2(a, b)   a##b
 #define CVTBL(tbl, cp) MERGE2(tbl, cp)
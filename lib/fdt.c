@@ -13,14 +13,6 @@
 #define OF_DT_TOKEN_NOP		   0x00000004
 #define OF_DT_END			   0x00000009
 
-static void _memcpy(void *dst, const void *src, size_t len)
-{
-	unsigned char		  *cdst = dst;
-	const unsigned char *csrc = src;
-	while (len--)
-		*cdst++ = *csrc++;
-}
-
 static inline unsigned int of_get_magic_number(void *blob)
 {
 	boot_param_header_t *header = (boot_param_header_t *)blob;
@@ -108,14 +100,24 @@ static inline void of_set_dt_struct_len(void *blob, unsigned int len)
 	header->dt_struct_len = swap_uint32(len);
 }
 
-static inline int of_blob_data_size(void *blob)
+static inline unsigned int of_get_offset_reserve_map(void *blob)
+{
+	boot_param_header_t *header = (boot_param_header_t *)blob;
+
+	return swap_uint32(header->offset_reserve_map);
+}
+
+/* end of the last block, what follows up to total_size is padding */
+static inline unsigned int of_blob_data_size(void *blob)
 {
-	return (unsigned int)of_get_offset_dt_strings(blob) + of_get_dt_strings_len(blob);
+	return max(of_get_offset_dt_strings(blob) + of_get_dt_strings_len(blob),
+			   of_get_offset_dt_struct(blob) + of_get_dt_struct_len(blob));
 }
 
 /* -------------------------------------------------------- */
 
-/* return the token and the next token offset
+/* return the token and the next token offset,
+ * tokens running past the structure block are reported as errors
  */
 static int of_get_token_nextoffset(void *blob, int startoffset, int *nextoffset, unsigned int *token)
 {
@@ -123,6 +125,7 @@ static int of_get_token_nextoffset(void *blob, int startoffset, int *nextoffset,
 	unsigned int		tag;
 	const char		   *cell;
 	unsigned int		offset = startoffset;
+	unsigned int		limit  = of_get_dt_struct_len(blob);
 
 	*nextoffset = -1;
 
@@ -131,6 +134,9 @@ static int of_get_token_nextoffset(void *blob, int startoffset, int *nextoffset,
 		return -1;
 	}
 
+	if (offset + 4 > limit)
+		return -1;
+
 	/* Get the token */
 	p	= (unsigned int *)of_dt_struct_offset(blob, offset);
 	tag = swap_uint32(*p);
@@ -140,10 +146,11 @@ static int of_get_token_nextoffset(void *blob, int startoffset, int *nextoffset,
 	if (tag == OF_DT_TOKEN_NODE_BEGIN) {
 		/* node name */
 		cell = (char *)of_dt_struct_offset(blob, offset);
-		do {
+		while (*cell != '\0') {
 			cell++;
-			offset++;
-		} while (*cell != '\0');
+			if (++offset >= limit)
+				return -1;
+		}
 		/* the \0 is part of the node name, hence offset must be updated to the
 		 * position past the \0.
 		 */
@@ -151,318 +158,1381 @@ static int of_get_token_nextoffset(void *blob, int startoffset, int *nextoffset,
 	} else if (tag == OF_DT_TOKEN_PROP) {
 		/* the property value size */
 		plen = (unsigned int *)of_dt_struct_offset(blob, offset);
+		if (offset + 8 > limit || swap_uint32(plen[0]) > limit - offset - 8 ||
+			swap_uint32(plen[1]) >= of_get_dt_strings_len(blob))
+			return -1;
 		/* name offset + value size + value */
 		offset += swap_uint32(*plen) + 8;
 	} else if ((tag != OF_DT_TOKEN_NODE_END) && (tag != OF_DT_TOKEN_NOP) && (tag != OF_DT_END))
 		return -1;
 
+	if (offset > limit)
+		return -1;
+
 	*nextoffset = OF_ALIGN(offset);
 	*token		= tag;
 
 	return 0;
 }
 
-static int of_get_nextnode_offset(void *blob, int start_offset, int *offset, int *nextoffset, int *depth)
+/* ---------------------------------------------------- */
+/* Paths: components are compared ignoring the unit address when the
+ * requested one has none, i.e. "/memory" matches "/memory@40000000".
+ */
+
+#define OF_HASH_INIT  2166136261u
+#define OF_HASH_PRIME 16777619u
+
+static unsigned int of_component_len(const char *p)
 {
-	int			 next_offset = 0;
-	int			 nodeoffset	 = start_offset;
-	unsigned int token;
-	int			 ret;
+	unsigned int len = 0;
 
-	if (!offset || !nextoffset || !depth)
-		return -1;
+	while (p[len] != '\0' && p[len] != '/')
+		len++;
+
+	return len;
+}
+
+/* FNV-1a of the component name without unit address, chained to the parent hash */
+static unsigned int of_path_hash_component(unsigned int hash, const char *p, unsigned int len)
+{
+	hash = (hash ^ '/') * OF_HASH_PRIME;
+	while (len-- && *p != '@')
+		hash = (hash ^ (unsigned char)*p++) * OF_HASH_PRIME;
+
+	return hash;
+}
+
+/* want is from a requested path, have is a node name */
+static int of_component_eq(const char *want, unsigned int wlen, const char *have, unsigned int hlen)
+{
+	if (memcmp(want, have, min(wlen, hlen)) != 0)
+		return 0;
+	if (wlen == hlen)
+		return 1;
+
+	return (wlen < hlen) && (have[wlen] == '@') && !memchr((void *)want, '@', wlen);
+}
+
+/* Compare the first components of a requested path with a node path.
+ * Returns the position in want after the matched components, or NULL.
+ */
+static const char *of_path_match_prefix(const char *want, const char *have)
+{
+	unsigned int wlen, hlen;
 
 	while (1) {
-		ret = of_get_token_nextoffset(blob, nodeoffset, &next_offset, &token);
-		if (ret)
-			return ret;
+		while (*have == '/')
+			have++;
+		if (*have == '\0')
+			return want;
+		while (*want == '/')
+			want++;
+
+		wlen = of_component_len(want);
+		hlen = of_component_len(have);
+		if (!wlen || !of_component_eq(want, wlen, have, hlen))
+			return NULL;
+
+		want += wlen;
+		have += hlen;
+	}
+}
 
-		if (token == OF_DT_TOKEN_NODE_BEGIN) {
-			/* find the node start token */
-			(*depth)++;
+static unsigned int of_path_hash(const char *path, unsigned int *depth)
+{
+	unsigned int hash = OF_HASH_INIT;
+	unsigned int len;
 
-			break;
-		} else {
-			nodeoffset = next_offset;
+	*depth = 0;
+	while (1) {
+		while (*path == '/')
+			path++;
+		if (*path == '\0')
+			return hash;
+		len	 = of_component_len(path);
+		hash = of_path_hash_component(hash, path, len);
+		path += len;
+		(*depth)++;
+	}
+}
 
-			if ((token == OF_DT_TOKEN_PROP) || (token == OF_DT_TOKEN_NOP))
-				continue;
-			else if (token == OF_DT_TOKEN_NODE_END) {
-				(*depth)--;
+/* ---------------------------------------------------- */
+/* Fixup transaction */
+
+typedef struct {
+	void		 *blob;
+	unsigned char *dst;
+	unsigned int   capacity;
+	unsigned int   pos;
+	unsigned int   depth;
+	char		  *path; /* current node path */
+	unsigned int   pathlen;
+	unsigned int   hash[OF_MAX_DEPTH];
+	char		  *strings; /* strings appended to the blob ones */
+	unsigned int   strings_len;
+	unsigned int   blob_strings_len;
+	unsigned int  *strtab; /* open addressed string offset + 1, 0 when free */
+	unsigned int   strtab_mask;
+} of_commit_ctx_t;
+
+static void *of_txn_alloc(fdt_txn_t *txn, unsigned int size)
+{
+	void *p;
+
+	size = OF_ALIGN(size);
+	if (txn->used + size > txn->size) {
+		error("DT: fixup arena full\r\n");
+		return NULL;
+	}
+	p = txn->arena + txn->used;
+	txn->used += size;
+
+	return p;
+}
+
+static char *of_txn_strdup(fdt_txn_t *txn, const char *string)
+{
+	unsigned int len = strlen(string) + 1;
+	char		*p	 = of_txn_alloc(txn, len);
+
+	if (p)
+		memcpy(p, string, len);
+
+	return p;
+}
+
+void fdt_txn_init(fdt_txn_t *txn, void *arena, unsigned int size)
+{
+	memset(txn, 0, sizeof(fdt_txn_t));
+	txn->arena = arena;
+	txn->size  = size;
+}
+
+/* Queue a property value for the node at path, the node is created if missing.
+ * A later edit of the same property is queued after the earlier one, which the
+ * commit retires. Queued edits are never modified, so a failed overlay can be
+ * rolled back by truncating the list.
+ */
+int fdt_txn_set(fdt_txn_t *txn, const char *path, const char *name, const void *value, unsigned int len)
+{
+	fdt_edit_t *edit, *same = NULL;
+	void	   *data;
+
+	if (*path != '/')
+		return -1;
+
+	if (!name)
+		name = "";
 
-				if ((*depth) < 0)
-					return -1; /* not found */
-			} else if (token == OF_DT_END)
-				return -1; /* not found*/
+	data = of_txn_alloc(txn, len);
+	if (!data)
+		return -1;
+	memcpy(data, value, len);
+
+	for (edit = txn->first; edit; edit = edit->next) {
+		if ((strcmp(edit->path, path) == 0) && (strcmp(edit->name, name) == 0)) {
+			same = edit;
+			break;
 		}
-	};
+	}
 
-	*offset		= nodeoffset;
-	*nextoffset = next_offset;
+	edit = of_txn_alloc(txn, sizeof(fdt_edit_t));
+	if (!edit)
+		return -1;
+
+	memset(edit, 0, sizeof(fdt_edit_t));
+	edit->path	= same ? same->path : of_txn_strdup(txn, path);
+	edit->name	= same ? same->name : of_txn_strdup(txn, name);
+	edit->value = data;
+	edit->len	= len;
+	if (!edit->path || !edit->name)
+		return -1;
+	edit->hash = of_path_hash(path, &edit->depth);
+	if (edit->depth >= OF_MAX_DEPTH)
+		return -1;
+
+	if (txn->last)
+		txn->last->next = edit;
+	else
+		txn->first = edit;
+	txn->last = edit;
+	txn->count++;
 
 	return 0;
 }
 
-static int of_get_node_offset(void *blob, const char *name, int *offset)
+/* Make sure the node exists, it gets created empty if missing */
+int fdt_txn_add_node(fdt_txn_t *txn, const char *path)
 {
-	int			 start_offset = 0;
-	int			 nodeoffset	  = 0;
-	int			 nextoffset	  = 0;
-	int			 depth		  = 0;
-	unsigned int token;
-	unsigned int namelen = strlen(name);
-	char		 *nodename;
-	int			 ret;
+	return fdt_txn_set(txn, path, NULL, NULL, 0);
+}
 
-	/* find the root node*/
-	ret = of_get_token_nextoffset(blob, 0, &start_offset, &token);
-	if (ret)
+int fdt_txn_set_string(fdt_txn_t *txn, const char *path, const char *name, const char *string)
+{
+	return fdt_txn_set(txn, path, name, string, strlen(string) + 1);
+}
+
+int fdt_txn_set_cells(fdt_txn_t *txn, const char *path, const char *name, const uint32_t *cells, unsigned int count)
+{
+	uint32_t	 data[8];
+	unsigned int i;
+
+	if (count > ARRAY_SIZE(data))
 		return -1;
 
-	while (1) {
-		ret = of_get_nextnode_offset(blob, start_offset, &nodeoffset, &nextoffset, &depth);
-		if (ret)
-			return ret;
+	for (i = 0; i < count; i++)
+		data[i] = swap_uint32(cells[i]);
 
-		if (depth < 0)
-			return -1;
+	return fdt_txn_set(txn, path, name, data, count * 4);
+}
+
+static int of_commit_write(of_commit_ctx_t *ctx, const void *data, unsigned int len)
+{
+	if (ctx->pos + len > ctx->capacity) {
+		error("DT: fixed up blob exceeds %u bytes\r\n", ctx->capacity);
+		return -1;
+	}
+	memcpy(ctx->dst + ctx->pos, data, len);
+	ctx->pos += len;
+
+	return 0;
+}
+
+static int of_commit_token(of_commit_ctx_t *ctx, unsigned int token)
+{
+	token = swap_uint32(token);
+
+	return of_commit_write(ctx, &token, 4);
+}
+
+static int of_commit_pad(of_commit_ctx_t *ctx)
+{
+	unsigned int zero = 0;
 
-		nodename = (char *)of_dt_struct_offset(blob, (nodeoffset + 4));
-		if ((memcmp(nodename, name, namelen) == 0) && ((nodename[namelen] == '\0') || (nodename[namelen] == '@')))
+	return of_commit_write(ctx, &zero, OF_ALIGN(ctx->pos) - ctx->pos);
+}
+
+static unsigned int of_string_hash(const char *string, unsigned int *len)
+{
+	unsigned int hash = OF_HASH_INIT;
+	const char	*p	  = string;
+
+	while (*p)
+		hash = (hash ^ (unsigned char)*p++) * OF_HASH_PRIME;
+	*len = p - string;
+
+	return hash;
+}
+
+/* String at offset of the new strings block, the blob ones followed by the appended ones */
+static const char *of_strtab_string(of_commit_ctx_t *ctx, unsigned int offset)
+{
+	if (offset < ctx->blob_strings_len)
+		return of_get_string_by_offset(ctx->blob, offset);
+
+	return &ctx->strings[offset - ctx->blob_strings_len];
+}
+
+/* Slot of string in the table, either holding it or the free one to insert it */
+static unsigned int of_strtab_slot(of_commit_ctx_t *ctx, const char *string, unsigned int hash, unsigned int len)
+{
+	unsigned int slot = hash & ctx->strtab_mask;
+
+	while (ctx->strtab[slot]) {
+		if (memcmp(of_strtab_string(ctx, ctx->strtab[slot] - 1), string, len + 1) == 0)
 			break;
+		slot = (slot + 1) & ctx->strtab_mask;
+	}
+
+	return slot;
+}
+
+/* Hash every string of the blob once, so inserting a property does not scan the strings block.
+ * Only whole strings are indexed, a name only present as the tail of another one gets appended.
+ */
+static int of_strtab_build(of_commit_ctx_t *ctx, fdt_txn_t *txn, unsigned int extra)
+{
+	unsigned int size = 64, count = extra, offset, len, hash, slot;
 
-		start_offset = nextoffset;
+	for (offset = 0; offset < ctx->blob_strings_len; offset++) {
+		if (*of_get_string_by_offset(ctx->blob, offset) == '\0')
+			count++;
 	}
+	/* keep the load under 1/2 */
+	while (size < 2 * count)
+		size <<= 1;
 
-	*offset = nextoffset;
+	ctx->strtab = of_txn_alloc(txn, size * sizeof(unsigned int));
+	if (!ctx->strtab)
+		return -1;
+	memset(ctx->strtab, 0, size * sizeof(unsigned int));
+	ctx->strtab_mask = size - 1;
+
+	for (offset = 0; offset < ctx->blob_strings_len; offset += len + 1) {
+		hash = of_string_hash(of_get_string_by_offset(ctx->blob, offset), &len);
+		slot = of_strtab_slot(ctx, of_get_string_by_offset(ctx->blob, offset), hash, len);
+		if (!ctx->strtab[slot])
+			ctx->strtab[slot] = offset + 1;
+	}
 
 	return 0;
 }
 
-/* -------------------------------------------------------- */
+/* Name offset in the new strings block: existing string, already appended one, or append it */
+static int of_commit_name_offset(of_commit_ctx_t *ctx, const char *name, unsigned int *nameoff)
+{
+	unsigned int len, hash, slot;
+
+	hash = of_string_hash(name, &len);
+	slot = of_strtab_slot(ctx, name, hash, len);
+	if (!ctx->strtab[slot]) {
+		memcpy(&ctx->strings[ctx->strings_len], name, len + 1);
+		ctx->strtab[slot] = ctx->blob_strings_len + ctx->strings_len + 1;
+		ctx->strings_len += len + 1;
+	}
+	*nameoff = ctx->strtab[slot] - 1;
+
+	return 0;
+}
 
-static int of_blob_move_dt_struct(void *blob, void *point, int oldlen, int newlen)
+static int of_commit_property(of_commit_ctx_t *ctx, fdt_edit_t *edit)
 {
-	void		 *dest = point + newlen;
-	void		 *src  = point + oldlen;
-	unsigned int len  = (char *)blob + of_blob_data_size(blob) - (char *)point - oldlen;
+	unsigned int hdr[3];
+	unsigned int nameoff;
 
-	int			 delta		   = newlen - oldlen;
-	unsigned int structlen	   = of_get_dt_struct_len(blob) + delta;
-	unsigned int stringsoffset = of_get_offset_dt_strings(blob) + delta;
+	if (of_commit_name_offset(ctx, edit->name, &nameoff))
+		return -1;
 
-	memmove(dest, src, len);
+	hdr[0] = swap_uint32(OF_DT_TOKEN_PROP);
+	hdr[1] = swap_uint32(edit->len);
+	hdr[2] = swap_uint32(nameoff);
+	if (of_commit_write(ctx, hdr, sizeof(hdr)) || of_commit_write(ctx, edit->value, edit->len) || of_commit_pad(ctx))
+		return -1;
 
-	of_set_dt_struct_len(blob, structlen);
-	of_set_offset_dt_strings(blob, stringsoffset);
+	edit->done = 1;
+	trace("DT: set %s:%s size %u\r\n", edit->path, edit->name, edit->len);
 
-	if (delta > 0)
-		of_set_dt_total_size(blob, fdt_get_total_size(blob) + delta);
+	return 0;
+}
+
+static void of_commit_path_push(of_commit_ctx_t *ctx, const char *name, unsigned int len)
+{
+	if (ctx->pathlen > 1)
+		ctx->path[ctx->pathlen++] = '/';
+	memcpy(&ctx->path[ctx->pathlen], name, len);
+	ctx->pathlen += len;
+	ctx->path[ctx->pathlen] = '\0';
+}
+
+static void of_commit_path_pop(of_commit_ctx_t *ctx)
+{
+	while (ctx->pathlen > 1 && ctx->path[ctx->pathlen - 1] != '/')
+		ctx->pathlen--;
+	if (ctx->pathlen > 1)
+		ctx->pathlen--;
+	ctx->path[ctx->pathlen] = '\0';
+}
+
+/* Write the last value queued for a property of the current node and retire the others,
+ * paths spelled with and without unit address can target the same node.
+ * Returns 1 when an edit was applied, 0 if there was none.
+ */
+static int of_commit_latest(of_commit_ctx_t *ctx, fdt_txn_t *txn, const char *name)
+{
+	fdt_edit_t *edit, *latest = NULL;
+
+	for (edit = txn->first; edit; edit = edit->next) {
+		if (edit->active && !edit->done && edit->depth == ctx->depth && strcmp(edit->name, name) == 0) {
+			edit->done = 1;
+			latest	   = edit;
+		}
+	}
+
+	if (!latest)
+		return 0;
+
+	/* node only edit */
+	if (*name == '\0')
+		return 1;
+
+	return of_commit_property(ctx, latest) ? -1 : 1;
+}
+
+/* New properties go before the first subnode, where the kernel stops looking for them */
+static int of_commit_pending_properties(of_commit_ctx_t *ctx, fdt_txn_t *txn)
+{
+	fdt_edit_t *edit;
+
+	for (edit = txn->first; edit; edit = edit->next) {
+		if (edit->active && !edit->done && edit->depth == ctx->depth) {
+			if (of_commit_latest(ctx, txn, edit->name) < 0)
+				return -1;
+		}
+	}
 
 	return 0;
 }
 
-static int of_blob_move_dt_string(void *blob, int newlen)
+/* Emit the nodes that edits below the current path need but the blob lacks */
+static int of_commit_new_nodes(of_commit_ctx_t *ctx, fdt_txn_t *txn)
 {
-	void *point = (void *)((unsigned int)blob + of_get_offset_dt_strings(blob) + of_get_dt_strings_len(blob));
+	fdt_edit_t	 *edit, *other;
+	const char	 *rest;
+	unsigned int len;
+
+	if (ctx->depth + 1 >= OF_MAX_DEPTH)
+		return -1;
 
-	void		 *dest		= point + newlen;
-	unsigned int len		= (char *)blob + of_blob_data_size(blob) - (char *)point;
-	unsigned int stringslen = of_get_dt_strings_len(blob) + newlen;
+	while (1) {
+		for (edit = txn->first; edit; edit = edit->next) {
+			if (!edit->done && edit->depth > ctx->depth && of_path_match_prefix(edit->path, ctx->path))
+				break;
+		}
+		if (!edit)
+			return 0;
 
-	memmove(dest, point, len);
+		rest = of_path_match_prefix(edit->path, ctx->path);
+		while (*rest == '/')
+			rest++;
+		len = of_component_len(rest);
 
-	of_set_dt_strings_len(blob, stringslen);
-	of_set_dt_total_size(blob, fdt_get_total_size(blob) + newlen);
+		if (of_commit_token(ctx, OF_DT_TOKEN_NODE_BEGIN) || of_commit_write(ctx, rest, len))
+			return -1;
+		if (of_commit_write(ctx, "\0\0\0", 4 - (len & 3)))
+			return -1;
+
+		of_commit_path_push(ctx, rest, len);
+		ctx->depth++;
+		trace("DT: adding node %s\r\n", ctx->path);
+
+		for (other = edit; other; other = other->next) {
+			if (!other->done && other->depth == ctx->depth && of_path_match_prefix(other->path, ctx->path))
+				other->active = 1;
+		}
+
+		if (of_commit_pending_properties(ctx, txn) || of_commit_new_nodes(ctx, txn) ||
+			of_commit_token(ctx, OF_DT_TOKEN_NODE_END))
+			return -1;
+
+		for (other = edit; other; other = other->next) {
+			if (other->depth == ctx->depth)
+				other->active = 0;
+		}
+
+		ctx->depth--;
+		of_commit_path_pop(ctx);
+	}
+}
+
+/* Walk the source blob once and write the edited blob to dst with a single forward copy.
+ * Properties of matching nodes are replaced or appended, missing nodes are created.
+ * Every write is bounded by the capacity of dst, which also gets its headroom.
+ */
+int fdt_txn_commit(fdt_txn_t *txn, fdt_t *src, fdt_t *dst)
+{
+	void				*blob = src->blob;
+	of_commit_ctx_t		 ctx;
+	boot_param_header_t *header;
+	fdt_edit_t			*edit;
+	unsigned int		*rsv, *p;
+	unsigned int		 token, struct_start, strings_max;
+	int					 offset = 0, nextoffset;
+	const char			*name;
+	unsigned int		 namelen, nameoff;
+	int					 ret;
+
+	if (fdt_check_header(blob, src->capacity)) {
+		error("DT: invalid blob\r\n");
+		return -1;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.blob	 = blob;
+	ctx.dst		 = dst->blob;
+	ctx.capacity = dst->capacity;
+
+	ctx.blob_strings_len = of_get_dt_strings_len(blob);
+
+	strings_max = 0;
+	for (edit = txn->first; edit; edit = edit->next) {
+		strings_max += strlen(edit->name) + 1;
+		edit->done = 0;
+	}
+	ctx.path	= of_txn_alloc(txn, OF_MAX_PATH);
+	ctx.strings = of_txn_alloc(txn, strings_max);
+	if (!ctx.path || !ctx.strings || of_strtab_build(&ctx, txn, txn->count))
+		return -1;
+
+	/* header, then the memory reserve map up to its terminating entry */
+	ctx.pos = sizeof(boot_param_header_t);
+	rsv		= (unsigned int *)((char *)blob + of_get_offset_reserve_map(blob));
+	do {
+		if ((char *)rsv + 16 > (char *)blob + of_get_offset_dt_struct(blob) || of_commit_write(&ctx, rsv, 16))
+			return -1;
+		rsv += 4;
+	} while (rsv[-4] | rsv[-3] | rsv[-2] | rsv[-1]);
+
+	struct_start = ctx.pos;
+
+	while (1) {
+		if (of_get_token_nextoffset(blob, offset, &nextoffset, &token)) {
+			error("DT: bad token at 0x%x\r\n", offset);
+			return -1;
+		}
+
+		if (token == OF_DT_TOKEN_NODE_BEGIN) {
+			if (ctx.depth + 1 >= OF_MAX_DEPTH)
+				return -1;
+			name	= (char *)of_dt_struct_offset(blob, offset + 4);
+			namelen = strlen(name);
+			if (ctx.pathlen + namelen + 2 > OF_MAX_PATH)
+				return -1;
+
+			if (namelen) {
+				if (of_commit_pending_properties(&ctx, txn))
+					return -1;
+				of_commit_path_push(&ctx, name, namelen);
+				ctx.depth++;
+				ctx.hash[ctx.depth] = of_path_hash_component(ctx.hash[ctx.depth - 1], name, namelen);
+			} else {
+				/* root node */
+				ctx.path[0]	= '/';
+				ctx.path[1]	= '\0';
+				ctx.pathlen = 1;
+				ctx.hash[0] = OF_HASH_INIT;
+			}
+
+			/* the first node matching a path gets its edits */
+			for (edit = txn->first; edit; edit = edit->next) {
+				if (!edit->done && !edit->active && edit->depth == ctx.depth && edit->hash == ctx.hash[ctx.depth] &&
+					of_path_match_prefix(edit->path, ctx.path))
+					edit->active = 1;
+			}
+		} else if (token == OF_DT_TOKEN_PROP) {
+			p		= (unsigned int *)of_dt_struct_offset(blob, offset + 8);
+			nameoff = swap_uint32(*p);
+			name	= of_get_string_by_offset(blob, nameoff);
+
+			ret = of_commit_latest(&ctx, txn, name);
+			if (ret < 0)
+				return -1;
+			if (ret) {
+				offset = nextoffset;
+				continue;
+			}
+		} else if (token == OF_DT_TOKEN_NOP) {
+			offset = nextoffset;
+			continue;
+		} else if (token == OF_DT_TOKEN_NODE_END) {
+			if (of_commit_pending_properties(&ctx, txn) || of_commit_new_nodes(&ctx, txn))
+				return -1;
+			for (edit = txn->first; edit; edit = edit->next) {
+				if (edit->active && edit->depth == ctx.depth)
+					edit->active = 0;
+			}
+			if (ctx.depth)
+				ctx.depth--;
+			of_commit_path_pop(&ctx);
+		}
+
+		/* unchanged token, copied as is */
+		if (of_commit_write(&ctx, (void *)of_dt_struct_offset(blob, offset), nextoffset - offset))
+			return -1;
+
+		if (token == OF_DT_END)
+			break;
+		offset = nextoffset;
+	}
+
+	header = (boot_param_header_t *)dst->blob;
+	memcpy(header, blob, sizeof(boot_param_header_t));
+	header->offset_reserve_map = swap_uint32(sizeof(boot_param_header_t));
+	header->offset_dt_struct   = swap_uint32(struct_start);
+	header->dt_struct_len	   = swap_uint32(ctx.pos - struct_start);
+	header->offset_dt_strings  = swap_uint32(ctx.pos);
+
+	if (of_commit_write(&ctx, of_get_string_by_offset(blob, 0), of_get_dt_strings_len(blob)) ||
+		of_commit_write(&ctx, ctx.strings, ctx.strings_len))
+		return -1;
+
+	header->dt_strings_len = swap_uint32(of_get_dt_strings_len(blob) + ctx.strings_len);
+	header->total_size	   = swap_uint32(min(ctx.pos + dst->headroom, dst->capacity));
+
+	for (edit = txn->first; edit; edit = edit->next) {
+		if (!edit->done) {
+			warning("DT: could not set %s:%s\r\n", edit->path, edit->name);
+			return -1;
+		}
+	}
+
+	debug("DT: %u fixups applied, size %u -> %u\r\n", txn->count, fdt_get_total_size(blob), ctx.pos);
 
 	return 0;
 }
 
-static int of_get_next_property_offset(void *blob, int startoffset, int *offset, int *nextproperty)
+/* ---------------------------------------------------- */
+/* Lookups */
+
+typedef int (*of_walk_cb_t)(void *arg, const char *path, const char *name, const void *value, unsigned int len);
+
+static char of_walk_path[OF_MAX_PATH];
+static char of_fixup_path[OF_MAX_PATH];
+
+/* Struct offset of the node at path, -1 if not found */
+static int of_find_node(void *blob, const char *path)
 {
+	const char	*pos[OF_MAX_DEPTH];
+	const char	*name;
+	unsigned int depth = 0, matched = 0, len;
 	unsigned int token;
-	int			 nextoffset;
-	int			 ret = -1;
+	int			 offset = 0, nextoffset;
 
 	while (1) {
-		ret = of_get_token_nextoffset(blob, startoffset, &nextoffset, &token);
-		if (ret)
-			break;
+		if (of_get_token_nextoffset(blob, offset, &nextoffset, &token) || token == OF_DT_END)
+			return -1;
+
+		if (token == OF_DT_TOKEN_NODE_BEGIN) {
+			if (++depth >= OF_MAX_DEPTH)
+				return -1;
+			if (matched == depth - 1) {
+				name = (char *)of_dt_struct_offset(blob, offset + 4);
+				if (depth > 1) {
+					while (*path == '/')
+						path++;
+					len = of_component_len(path);
+					if (!of_component_eq(path, len, name, strlen(name))) {
+						offset = nextoffset;
+						continue;
+					}
+				}
+				pos[matched++] = path;
+				if (depth > 1)
+					path += len;
+				while (*path == '/')
+					path++;
+				if (*path == '\0')
+					return offset;
+			}
+		} else if (token == OF_DT_TOKEN_NODE_END) {
+			if (matched == depth)
+				path = pos[--matched];
+			depth--;
+		}
+
+		offset = nextoffset;
+	}
+}
+
+/* Value of a property of the node at nodeoffset, NULL if not found */
+const void *fdt_getprop(void *blob, int nodeoffset, const char *name, unsigned int *len)
+{
+	const unsigned int *p;
+	unsigned int		token;
+	int					offset, nextoffset;
+
+	if (of_get_token_nextoffset(blob, nodeoffset, &offset, &token) || token != OF_DT_TOKEN_NODE_BEGIN)
+		return NULL;
 
+	while (1) {
+		if (of_get_token_nextoffset(blob, offset, &nextoffset, &token))
+			return NULL;
 		if (token == OF_DT_TOKEN_PROP) {
-			*offset		  = startoffset;
-			*nextproperty = nextoffset;
-			ret			  = 0;
-			break;
-		} else if (token == OF_DT_TOKEN_NOP)
-			continue;
-		else {
-			ret = -1;
-			break;
+			p = (unsigned int *)of_dt_struct_offset(blob, offset + 4);
+			if (strcmp(of_get_string_by_offset(blob, swap_uint32(p[1])), name) == 0) {
+				if (len)
+					*len = swap_uint32(p[0]);
+				return &p[2];
+			}
+		} else if (token != OF_DT_TOKEN_NOP)
+			return NULL;
+		offset = nextoffset;
+	}
+}
+
+/* Call cb for the properties of the node at nodeoffset and for every node and property below it.
+ * Paths are built in of_walk_path from its current content, nodes are reported with a NULL name.
+ */
+static int of_walk_subtree(void *blob, int nodeoffset, of_walk_cb_t cb, void *arg)
+{
+	unsigned int   pathlen[OF_MAX_DEPTH];
+	unsigned int   depth = 0, token, len;
+	const uint32_t *p;
+	const char	   *name;
+	int			   offset = nodeoffset, nextoffset;
+
+	while (1) {
+		if (of_get_token_nextoffset(blob, offset, &nextoffset, &token))
+			return -1;
+
+		if (token == OF_DT_TOKEN_NODE_BEGIN) {
+			if (depth + 1 >= OF_MAX_DEPTH)
+				return -1;
+			pathlen[depth] = strlen(of_walk_path);
+			if (depth++) {
+				name = (char *)of_dt_struct_offset(blob, offset + 4);
+				len	 = pathlen[depth - 1];
+				if (len + strlen(name) + 2 > OF_MAX_PATH)
+					return -1;
+				if (len == 0 || of_walk_path[len - 1] != '/')
+					of_walk_path[len++] = '/';
+				strcpy(&of_walk_path[len], name);
+				if (cb(arg, of_walk_path, NULL, NULL, 0))
+					return -1;
+			}
+		} else if (token == OF_DT_TOKEN_PROP) {
+			p	 = (uint32_t *)of_dt_struct_offset(blob, offset + 4);
+			name = of_get_string_by_offset(blob, swap_uint32(p[1]));
+			if (cb(arg, of_walk_path[0] ? of_walk_path : "/", name, &p[2], swap_uint32(p[0])))
+				return -1;
+		} else if (token == OF_DT_TOKEN_NODE_END) {
+			of_walk_path[pathlen[--depth]] = '\0';
+			if (depth == 0)
+				return 0;
+		} else if (token == OF_DT_END)
+			return -1;
+
+		offset = nextoffset;
+	}
+}
+
+/* Next node after startoffset (-1 to include the root) with compatible in its list */
+int fdt_node_offset_by_compatible(void *blob, int startoffset, const char *compatible)
+{
+	const char	*list;
+	unsigned int len, pos, token;
+	int			 offset = 0, nextoffset;
+
+	if (startoffset >= 0 && of_get_token_nextoffset(blob, startoffset, &offset, &token))
+		return -1;
+
+	while (1) {
+		if (of_get_token_nextoffset(blob, offset, &nextoffset, &token) || token == OF_DT_END)
+			return -1;
+
+		if (token == OF_DT_TOKEN_NODE_BEGIN) {
+			list = fdt_getprop(blob, offset, "compatible", &len);
+			for (pos = 0; list && pos < len; pos += strlen(&list[pos]) + 1) {
+				if (strcmp(&list[pos], compatible) == 0)
+					return offset;
+			}
 		}
 
-		startoffset = nextoffset;
-	};
+		offset = nextoffset;
+	}
+}
+
+/* ---------------------------------------------------- */
+/* Node index: path and phandle tables built in one walk on the first lookup */
+
+static char of_index_path[OF_MAX_PATH];
 
-	return ret;
+static inline unsigned int of_read_cell(const void *p)
+{
+	return swap_uint32(*(const unsigned int *)p);
+}
+
+static inline void of_write_cell(void *p, unsigned int value)
+{
+	*(unsigned int *)p = swap_uint32(value);
+}
+
+static int of_is_phandle(const char *name, unsigned int len)
+{
+	return (len == 4) && (strcmp(name, "phandle") == 0 || strcmp(name, "linux,phandle") == 0);
 }
 
-static int of_get_property_offset_by_name(void *blob, unsigned int nodeoffset, const char *name, int *offset)
+static inline const char *of_index_name(fdt_index_t *index, unsigned int node)
 {
-	unsigned int  nameoffset;
-	unsigned int *p;
-	unsigned int  namelen		  = strlen(name);
-	int			  startoffset	  = nodeoffset;
-	int			  property_offset = 0;
-	int			  nextoffset	  = 0;
-	char		 *string;
-	int			  ret;
+	return (char *)of_dt_struct_offset(index->blob, index->nodes[node].offset + 4);
+}
+
+static int of_index_build(fdt_txn_t *txn, void *blob)
+{
+	fdt_index_t		 *index = &txn->index;
+	fdt_node_t		 *node;
+	unsigned int	  stack[OF_MAX_DEPTH];
+	unsigned int	  depth = 0, token, size, i, slot;
+	const uint32_t *p;
+	const char	   *name;
+	int				offset = 0, nextoffset;
+
+	if (index->blob == blob)
+		return 0;
 
-	*offset = 0;
+	memset(index, 0, sizeof(fdt_index_t));
+	txn->phandles	 = NULL;
+	txn->symbols	 = NULL;
+	txn->max_phandle = 0;
+
+	/* the nodes are allocated one by one during the walk, nothing else is, so they stay contiguous */
+	index->nodes = (fdt_node_t *)(txn->arena + txn->used);
 
 	while (1) {
-		ret = of_get_next_property_offset(blob, startoffset, &property_offset, &nextoffset);
-		if (ret)
-			return ret;
-
-		p		   = (unsigned int *)of_dt_struct_offset(blob, property_offset + 8);
-		nameoffset = swap_uint32(*p);
-		string	   = of_get_string_by_offset(blob, nameoffset);
-		if ((strlen(string) == namelen) && (memcmp(string, name, namelen) == 0)) {
-			*offset = property_offset;
-			return 0;
+		if (of_get_token_nextoffset(blob, offset, &nextoffset, &token))
+			return -1;
+
+		if (token == OF_DT_TOKEN_NODE_BEGIN) {
+			if (depth >= OF_MAX_DEPTH)
+				return -1;
+			node = of_txn_alloc(txn, sizeof(fdt_node_t));
+			if (!node)
+				return -1;
+			name		  = (char *)of_dt_struct_offset(blob, offset + 4);
+			node->offset  = offset;
+			node->phandle = 0;
+			node->parent  = depth ? stack[depth - 1] : index->count;
+			node->hash	  = depth ? of_path_hash_component(index->nodes[node->parent].hash, name, strlen(name))
+								  : OF_HASH_INIT;
+			stack[depth++] = index->count++;
+		} else if (token == OF_DT_TOKEN_PROP && depth) {
+			p	 = (uint32_t *)of_dt_struct_offset(blob, offset + 4);
+			name = of_get_string_by_offset(blob, swap_uint32(p[1]));
+			if (of_is_phandle(name, swap_uint32(p[0])))
+				index->nodes[stack[depth - 1]].phandle = of_read_cell(&p[2]);
+		} else if (token == OF_DT_TOKEN_NODE_END) {
+			if (!depth--)
+				return -1;
+		} else if (token == OF_DT_END)
+			break;
+
+		offset = nextoffset;
+	}
+
+	/* keep the load under 1/2 */
+	size = 64;
+	while (size < 2 * index->count)
+		size <<= 1;
+
+	index->paths	= of_txn_alloc(txn, size * sizeof(unsigned int));
+	index->phandles = of_txn_alloc(txn, size * sizeof(unsigned int));
+	if (!index->paths || !index->phandles)
+		return -1;
+	memset(index->paths, 0, size * sizeof(unsigned int));
+	memset(index->phandles, 0, size * sizeof(unsigned int));
+	index->mask = size - 1;
+
+	/* in document order, so the first of the nodes matching a path is found first */
+	for (i = 0; i < index->count; i++) {
+		node = &index->nodes[i];
+		for (slot = node->hash & index->mask; index->paths[slot]; slot = (slot + 1) & index->mask)
+			;
+		index->paths[slot] = i + 1;
+
+		if (node->phandle) {
+			for (slot = (node->phandle * OF_HASH_PRIME) & index->mask; index->phandles[slot];
+				 slot = (slot + 1) & index->mask)
+				;
+			index->phandles[slot] = i + 1;
+			index->max_phandle	  = max(index->max_phandle, node->phandle);
 		}
-		startoffset = nextoffset;
 	}
 
-	return -1;
+	index->blob		 = blob;
+	txn->max_phandle = index->max_phandle;
+	debug("DT: indexed %u nodes, max phandle 0x%x\r\n", index->count, index->max_phandle);
+
+	return 0;
 }
 
-static int of_string_is_find_strings_blob(void *blob, const char *string, int *offset)
+/* Compare the names from node up to the root with the depth components of path */
+static int of_index_match(fdt_index_t *index, unsigned int node, const char *path, unsigned int depth)
 {
-	char *dt_strings	= (char *)blob + of_get_offset_dt_strings(blob);
-	int	  dt_stringslen = of_get_dt_strings_len(blob);
-	int	  len			= strlen(string) + 1;
-	char *lastpoint		= dt_strings + dt_stringslen - len;
-	char *p;
+	const char	*component[OF_MAX_DEPTH];
+	unsigned int len[OF_MAX_DEPTH];
+	unsigned int i;
+	const char	*name;
+
+	for (i = 0; i < depth; i++) {
+		while (*path == '/')
+			path++;
+		component[i] = path;
+		len[i]		 = of_component_len(path);
+		path += len[i];
+	}
 
-	for (p = dt_strings; p <= lastpoint; p++) {
-		if (memcmp(p, string, len) == 0) {
-			*offset = p - dt_strings;
+	while (depth--) {
+		if (index->nodes[node].parent == node)
 			return 0;
-		}
+		name = of_index_name(index, node);
+		if (!of_component_eq(component[depth], len[depth], name, strlen(name)))
+			return 0;
+		node = index->nodes[node].parent;
+	}
+
+	return index->nodes[node].parent == node;
+}
+
+static int of_index_by_path(fdt_index_t *index, const char *path)
+{
+	unsigned int hash, depth, slot, node;
+
+	hash = of_path_hash(path, &depth);
+	if (depth >= OF_MAX_DEPTH)
+		return -1;
+
+	for (slot = hash & index->mask; index->paths[slot]; slot = (slot + 1) & index->mask) {
+		node = index->paths[slot] - 1;
+		if (index->nodes[node].hash == hash && of_index_match(index, node, path, depth))
+			return node;
 	}
 
 	return -1;
 }
 
-static int of_add_string_strings_blob(void *blob, const char *string, int *name_offset)
+static int of_index_by_phandle(fdt_index_t *index, unsigned int phandle)
 {
-	char *dt_strings	= (char *)blob + of_get_offset_dt_strings(blob);
-	int	  dt_stringslen = of_get_dt_strings_len(blob);
-	char *new_string;
-	int	  len = strlen(string) + 1;
-	int	  ret;
+	unsigned int slot, node;
 
-	new_string = dt_strings + dt_stringslen;
-	ret		   = of_blob_move_dt_string(blob, len);
-	if (ret)
-		return ret;
+	for (slot = (phandle * OF_HASH_PRIME) & index->mask; index->phandles[slot]; slot = (slot + 1) & index->mask) {
+		node = index->phandles[slot] - 1;
+		if (index->nodes[node].phandle == phandle)
+			return node;
+	}
 
-	_memcpy(new_string, string, len);
+	return -1;
+}
 
-	*name_offset = new_string - dt_strings;
+/* Nodes are in document order, so by increasing offset */
+static int of_index_by_offset(fdt_index_t *index, int offset)
+{
+	unsigned int low = 0, high = index->count, mid;
+
+	while (low < high) {
+		mid = (low + high) / 2;
+		if ((int)index->nodes[mid].offset < offset)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return (low < index->count && (int)index->nodes[low].offset == offset) ? (int)low : -1;
+}
+
+static int of_index_get_path(fdt_index_t *index, unsigned int node, char *buf, unsigned int size)
+{
+	unsigned int chain[OF_MAX_DEPTH];
+	unsigned int depth = 0, len = 0, namelen;
+	const char	*name;
+
+	while (index->nodes[node].parent != node) {
+		if (depth >= OF_MAX_DEPTH)
+			return -1;
+		chain[depth++] = node;
+		node		   = index->nodes[node].parent;
+	}
+
+	if (size < 2)
+		return -1;
+	buf[len++] = '/';
+
+	while (depth--) {
+		name	= of_index_name(index, chain[depth]);
+		namelen = strlen(name);
+		if (len + namelen + 2 > size)
+			return -1;
+		if (len > 1)
+			buf[len++] = '/';
+		memcpy(&buf[len], name, namelen);
+		len += namelen;
+	}
+	buf[len] = '\0';
 
 	return 0;
 }
 
-static int of_add_property(void *blob, int nextoffset, const char *property_name, const void *value, int valuelen)
+/* Offset of the node at path, "/memory" also matches "/memory@40000000" */
+int fdt_path_offset(fdt_txn_t *txn, void *blob, const char *path)
 {
-	int			  string_offset;
-	unsigned int *p;
-	unsigned int  addr;
-	int			  len;
-	int			  ret;
+	int node;
+
+	if (of_index_build(txn, blob))
+		return -1;
+
+	node = of_index_by_path(&txn->index, path);
+
+	return (node < 0) ? -1 : (int)txn->index.nodes[node].offset;
+}
 
-	/* check if the property name in the dt_strings,
-	 * else add the string in dt strings
-	 */
-	ret = of_string_is_find_strings_blob(blob, property_name, &string_offset);
-	if (ret) {
-		ret = of_add_string_strings_blob(blob, property_name, &string_offset);
-		if (ret)
-			return ret;
+int fdt_node_offset_by_phandle(fdt_txn_t *txn, void *blob, unsigned int phandle)
+{
+	int node;
+
+	if (of_index_build(txn, blob))
+		return -1;
+
+	node = of_index_by_phandle(&txn->index, phandle);
+
+	return (node < 0) ? -1 : (int)txn->index.nodes[node].offset;
+}
+
+/* Full path of the node at nodeoffset, to queue edits on a node found by phandle or compatible */
+int fdt_get_path(fdt_txn_t *txn, void *blob, int nodeoffset, char *buf, unsigned int size)
+{
+	int node;
+
+	if (of_index_build(txn, blob))
+		return -1;
+
+	node = of_index_by_offset(&txn->index, nodeoffset);
+	if (node < 0)
+		return -1;
+
+	return of_index_get_path(&txn->index, node, buf, size);
+}
+
+/* ---------------------------------------------------- */
+/* Overlays */
+
+static int of_add_phandle(fdt_txn_t *txn, unsigned int phandle, const char *path)
+{
+	fdt_phandle_t *entry = of_txn_alloc(txn, sizeof(fdt_phandle_t));
+
+	if (!entry)
+		return -1;
+
+	entry->phandle = phandle;
+	entry->path	   = of_txn_strdup(txn, path);
+	entry->next	   = txn->phandles;
+	txn->phandles  = entry;
+
+	if (phandle > txn->max_phandle)
+		txn->max_phandle = phandle;
+
+	return entry->path ? 0 : -1;
+}
+
+/* Nodes added by the overlays applied so far, then the base tree */
+static const char *of_phandle_path(fdt_txn_t *txn, unsigned int phandle)
+{
+	fdt_phandle_t *entry;
+	int			   node;
+
+	for (entry = txn->phandles; entry; entry = entry->next) {
+		if (entry->phandle == phandle)
+			return entry->path;
+	}
+
+	node = of_index_by_phandle(&txn->index, phandle);
+	if (node < 0 || of_index_get_path(&txn->index, node, of_index_path, OF_MAX_PATH))
+		return NULL;
+
+	return of_index_path;
+}
+
+static unsigned int of_path_phandle(fdt_txn_t *txn, const char *path)
+{
+	fdt_phandle_t *entry;
+	int			   node;
+
+	for (entry = txn->phandles; entry; entry = entry->next) {
+		if (strcmp(entry->path, path) == 0)
+			return entry->phandle;
+	}
+
+	node = of_index_by_path(&txn->index, path);
+
+	return (node < 0) ? 0 : txn->index.nodes[node].phandle;
+}
+
+/* Symbols of the overlays applied before, then those of the base tree */
+static const char *of_symbol_path(fdt_txn_t *txn, void *blob, const char *label)
+{
+	fdt_symbol_t *symbol;
+	int			  offset;
+
+	for (symbol = txn->symbols; symbol; symbol = symbol->next) {
+		if (strcmp(symbol->label, label) == 0)
+			return symbol->path;
 	}
 
-	/* add the property node in dt struct */
-	len	 = 12 + OF_ALIGN(valuelen);
-	addr = of_dt_struct_offset(blob, nextoffset);
-	ret	 = of_blob_move_dt_struct(blob, (void *)addr, 0, len);
-	if (ret)
-		return ret;
+	offset = fdt_path_offset(txn, blob, "/__symbols__");
+	if (offset < 0)
+		return NULL;
+
+	return fdt_getprop(blob, offset, label, NULL);
+}
+
+typedef struct {
+	fdt_txn_t	*txn;
+	void		*blob;
+	void		*overlay;
+	unsigned int delta;
+} of_overlay_ctx_t;
 
-	p = (unsigned int *)addr;
+static int of_renumber_cb(void *arg, const char *path, const char *name, const void *value, unsigned int len)
+{
+	of_overlay_ctx_t *ctx = arg;
 
-	/* set property node: token, value size, name offset, value */
-	*p++ = swap_uint32(OF_DT_TOKEN_PROP);
-	*p++ = swap_uint32(valuelen);
-	*p++ = swap_uint32(string_offset);
-	_memcpy((unsigned char *)p, value, valuelen);
+	if (name && of_is_phandle(name, len))
+		of_write_cell((void *)value, of_read_cell(value) + ctx->delta);
 
 	return 0;
 }
 
-static int of_update_property_value(void *blob, int property_offset, const void *value, int valuelen)
+/* __local_fixups__ mirrors the overlay nodes, each property lists where its phandle references are */
+static int of_local_fixup_cb(void *arg, const char *path, const char *name, const void *value, unsigned int len)
 {
-	int			   oldlen;
-	unsigned int	 *plen;
-	unsigned char *pvalue;
-	void		  *point;
-	int			   ret;
+	of_overlay_ctx_t *ctx = arg;
+	unsigned char	 *prop;
+	unsigned int	  proplen, i, at;
+	int				  offset;
+
+	if (!name)
+		return 0;
+
+	offset = of_find_node(ctx->overlay, path);
+	prop   = (offset < 0) ? NULL : (unsigned char *)fdt_getprop(ctx->overlay, offset, name, &proplen);
+	if (!prop) {
+		error("DT: local fixup %s:%s not found\r\n", path, name);
+		return -1;
+	}
 
-	plen   = (unsigned int *)of_dt_struct_offset(blob, property_offset + 4);
-	pvalue = (unsigned char *)of_dt_struct_offset(blob, property_offset + 12);
-	point  = (void *)pvalue;
+	for (i = 0; i + 4 <= len; i += 4) {
+		at = of_read_cell((const char *)value + i);
+		if (proplen < 4 || at > proplen - 4) {
+			error("DT: local fixup %s:%s out of the property\r\n", path, name);
+			return -1;
+		}
+		of_write_cell(&prop[at], of_read_cell(&prop[at]) + ctx->delta);
+	}
 
-	/* get the old len of value */
-	oldlen = swap_uint32(*plen);
+	return 0;
+}
 
-	ret = of_blob_move_dt_struct(blob, point, OF_ALIGN(oldlen), OF_ALIGN(valuelen));
-	if (ret)
-		return ret;
+/* __fixups__ properties are labels of the base tree with a list of "path:property:offset" */
+static int of_fixup_cb(void *arg, const char *path, const char *name, const void *value, unsigned int len)
+{
+	of_overlay_ctx_t *ctx = arg;
+	const char		 *entry = value, *end = entry + len, *prop, *at;
+	const char		 *target;
+	unsigned char	 *data;
+	unsigned int	  phandle, proplen, pos;
+	int				  offset;
+
+	if (!name)
+		return 0;
+
+	target	= of_symbol_path(ctx->txn, ctx->blob, name);
+	phandle = target ? of_path_phandle(ctx->txn, target) : 0;
+	if (!phandle) {
+		error("DT: overlay symbol %s not found\r\n", name);
+		return -1;
+	}
 
-	/* set the new len and value */
-	*plen = swap_uint32(valuelen);
+	while (entry < end) {
+		prop = memchr((void *)entry, ':', end - entry);
+		at	 = prop ? memchr((void *)(prop + 1), ':', end - prop - 1) : NULL;
+		if (!at || (unsigned int)(prop - entry) >= OF_MAX_PATH || (unsigned int)(at - prop - 1) >= OF_MAX_PATH) {
+			error("DT: invalid fixup for %s\r\n", name);
+			return -1;
+		}
 
-	_memcpy(pvalue, value, valuelen);
+		memcpy(of_fixup_path, entry, prop - entry);
+		of_fixup_path[prop - entry] = '\0';
+
+		pos = 0;
+		for (entry = at + 1; entry < end && *entry >= '0' && *entry <= '9'; entry++) {
+			if (pos > (UINT32_MAX - 9) / 10) {
+				error("DT: fixup offset for %s too large\r\n", name);
+				return -1;
+			}
+			pos = pos * 10 + (*entry - '0');
+		}
+
+		offset = of_find_node(ctx->overlay, of_fixup_path);
+		/* the property name is terminated by the ':' */
+		memcpy(of_fixup_path, prop + 1, at - prop - 1);
+		of_fixup_path[at - prop - 1] = '\0';
+		data = (offset < 0) ? NULL : (unsigned char *)fdt_getprop(ctx->overlay, offset, of_fixup_path, &proplen);
+		if (!data || proplen < 4 || pos > proplen - 4) {
+			error("DT: fixup for %s out of the overlay\r\n", name);
+			return -1;
+		}
+		of_write_cell(&data[pos], phandle);
+
+		/* skip the string terminator */
+		entry++;
+	}
 
 	return 0;
 }
 
-static int of_set_property(void *blob, int nodeoffset, const char *property_name, void *value, int valuelen)
+static int of_fragment_cb(void *arg, const char *path, const char *name, const void *value, unsigned int len)
+{
+	of_overlay_ctx_t *ctx = arg;
+
+	if (!name)
+		return fdt_txn_add_node(ctx->txn, path);
+
+	if (of_is_phandle(name, len) && of_add_phandle(ctx->txn, of_read_cell(value), path))
+		return -1;
+
+	return fdt_txn_set(ctx->txn, path, name, value, len);
+}
+
+/* Target path of /fragment@N, from target-path or the target phandle */
+static const char *of_fragment_target(of_overlay_ctx_t *ctx, int fragment)
 {
-	int property_offset;
-	int ret;
+	const void *value;
 
-	/* If find the property name in the dt blob, update its value,
-	 * else to add this property
-	 */
-	ret = of_get_property_offset_by_name(blob, nodeoffset, property_name, &property_offset);
-	if (ret) {
-		trace("DT: adding property %s size %u\r\n", property_name, valuelen);
-		ret = of_add_property(blob, nodeoffset, property_name, value, valuelen);
-		if (ret)
-			warning("DT: fail to add property\r\n");
+	value = fdt_getprop(ctx->overlay, fragment, "target-path", NULL);
+	if (value)
+		return value;
 
-		return ret;
+	value = fdt_getprop(ctx->overlay, fragment, "target", NULL);
+	if (value)
+		return of_phandle_path(ctx->txn, of_read_cell(value));
+
+	return NULL;
+}
+
+/* strstr() within len, for property values */
+static const char *of_memstr(const char *buf, unsigned int len, const char *str)
+{
+	unsigned int n = strlen(str), i;
+
+	for (i = 0; i + n <= len; i++) {
+		if (!memcmp(buf + i, str, n))
+			return buf + i;
 	}
 
-	ret = of_update_property_value(blob, property_offset, value, valuelen);
-	if (ret) {
-		warning("DT: fail to update property\r\n");
-		return ret;
+	return NULL;
+}
+
+/* Overlay symbols point to /fragment@N/__overlay__/..., rebase them on the fragment target */
+static int of_symbol_cb(void *arg, const char *path, const char *name, const void *value, unsigned int len)
+{
+	of_overlay_ctx_t *ctx = arg;
+	const char		 *rest, *target;
+	fdt_symbol_t	 *symbol;
+	unsigned int	  fraglen;
+	int				  fragment;
+
+	/* the value is a path string, only trust it when terminated within the property */
+	if (!name || !len || ((const char *)value)[len - 1] != '\0')
+		return 0;
+
+	rest = of_memstr(value, len, "/__overlay__");
+	if (!rest || (unsigned int)(rest - (const char *)value) >= OF_MAX_PATH)
+		return 0;
+
+	fraglen = rest - (const char *)value;
+	memcpy(of_fixup_path, value, fraglen);
+	of_fixup_path[fraglen] = '\0';
+	fragment			   = of_find_node(ctx->overlay, of_fixup_path);
+	target				   = (fragment < 0) ? NULL : of_fragment_target(ctx, fragment);
+	if (!target)
+		return 0;
+
+	rest += strlen("/__overlay__");
+	if (strlen(target) + strlen(rest) + 1 >= OF_MAX_PATH)
+		return -1;
+	strcpy(of_fixup_path, target);
+	if (*rest && strcmp(of_fixup_path, "/") != 0)
+		strcat(of_fixup_path, rest);
+	else if (*rest)
+		strcpy(of_fixup_path, rest);
+
+	symbol = of_txn_alloc(ctx->txn, sizeof(fdt_symbol_t));
+	if (!symbol)
+		return -1;
+	symbol->label	  = of_txn_strdup(ctx->txn, name);
+	symbol->path	  = of_txn_strdup(ctx->txn, of_fixup_path);
+	symbol->next	  = ctx->txn->symbols;
+	ctx->txn->symbols = symbol;
+	if (!symbol->label || !symbol->path)
+		return -1;
+
+	return fdt_txn_set_string(ctx->txn, "/__symbols__", name, of_fixup_path);
+}
+
+static int of_overlay_walk(of_overlay_ctx_t *ctx, const char *path, of_walk_cb_t cb)
+{
+	int offset = of_find_node(ctx->overlay, path);
+
+	if (offset < 0)
+		return 0;
+
+	of_walk_path[0] = '\0';
+
+	return of_walk_subtree(ctx->overlay, offset, cb, ctx);
+}
+
+static int of_overlay_fragments(of_overlay_ctx_t *ctx)
+{
+	unsigned int token, depth = 0;
+	const char	*name, *target;
+	int			 offset = 0, nextoffset, content;
+
+	while (1) {
+		if (of_get_token_nextoffset(ctx->overlay, offset, &nextoffset, &token) || token == OF_DT_END)
+			return 0;
+
+		if (token == OF_DT_TOKEN_NODE_BEGIN && depth++ == 1) {
+			name = (char *)of_dt_struct_offset(ctx->overlay, offset + 4);
+			if (strncmp(name, "__", 2) != 0) {
+				target = of_fragment_target(ctx, offset);
+				if (!target) {
+					error("DT: overlay %s has no valid target\r\n", name);
+					return -1;
+				}
+
+				if (strlen(name) + sizeof("//__overlay__") > OF_MAX_PATH)
+					return -1;
+				strcpy(of_fixup_path, "/");
+				strcat(of_fixup_path, name);
+				strcat(of_fixup_path, "/__overlay__");
+				content = of_find_node(ctx->overlay, of_fixup_path);
+				if (content >= 0) {
+					trace("DT: overlay %s on %s\r\n", name, target);
+					strcpy(of_walk_path, target);
+					if (of_walk_subtree(ctx->overlay, content, of_fragment_cb, ctx))
+						return -1;
+				}
+			}
+		} else if (token == OF_DT_TOKEN_NODE_END)
+			depth--;
+
+		offset = nextoffset;
 	}
-	trace("DT: updated property %s size %u\r\n", property_name, valuelen);
+}
+
+/* Queue the content of a compiled overlay (dtc -@) on top of blob.
+ * The overlay blob is modified in place to renumber its phandles and resolve
+ * references to the base tree. On error nothing of it is applied.
+ */
+int fdt_overlay_apply(fdt_txn_t *txn, void *blob, void *overlay)
+{
+	of_overlay_ctx_t ctx;
+	fdt_txn_t		 saved;
+
+	if (fdt_check_blob_valid(overlay) || fdt_check_header(overlay, fdt_get_total_size(overlay))) {
+		error("DT: invalid overlay\r\n");
+		return -1;
+	}
+
+	if (of_index_build(txn, blob))
+		return -1;
+
+	memcpy(&saved, txn, sizeof(fdt_txn_t));
+
+	ctx.txn		= txn;
+	ctx.blob	= blob;
+	ctx.overlay = overlay;
+	ctx.delta	= txn->max_phandle;
+
+	if (of_overlay_walk(&ctx, "/", of_renumber_cb) || of_overlay_walk(&ctx, "/__local_fixups__", of_local_fixup_cb) ||
+		of_overlay_walk(&ctx, "/__fixups__", of_fixup_cb) || of_overlay_fragments(&ctx) ||
+		of_overlay_walk(&ctx, "/__symbols__", of_symbol_cb)) {
+		error("DT: overlay not applied\r\n");
+		if (saved.last)
+			saved.last->next = NULL;
+		memcpy(txn, &saved, sizeof(fdt_txn_t));
+		return -1;
+	}
+
+	debug("DT: overlay applied, %u edits queued\r\n", txn->count);
 
 	return 0;
 }
@@ -474,105 +1544,146 @@ int fdt_check_blob_valid(void *blob)
 	return ((of_get_magic_number(blob) == OF_DT_MAGIC) && (of_get_format_version(blob) >= 17)) ? 0 : 1;
 }
 
-/* The /chosen node
- * property "bootargs": This zero-terminated string is passed
- * as the kernel command line.
- */
-int fdt_update_bootargs(void *blob, const char *bootargs)
+/* Check the whole header: blocks aligned, in order and inside total_size, itself within capacity */
+int fdt_check_header(void *blob, unsigned int capacity)
 {
-	int	  nodeoffset;
-	int	  valuelen = strlen(bootargs) + 1;
-	int	  ret;
+	unsigned int size		 = fdt_get_total_size(blob);
+	unsigned int rsv		 = of_get_offset_reserve_map(blob);
+	unsigned int dt_struct	 = of_get_offset_dt_struct(blob);
+	unsigned int struct_len	 = of_get_dt_struct_len(blob);
+	unsigned int strings	 = of_get_offset_dt_strings(blob);
+	unsigned int strings_len = of_get_dt_strings_len(blob);
+
+	if (fdt_check_blob_valid(blob))
+		return -1;
+
+	if (size > capacity || size < sizeof(boot_param_header_t)) {
+		error("DT: size %u over %u\r\n", size, capacity);
+		return -1;
+	}
+
+	if ((rsv % 8) || (dt_struct % 4) || (struct_len % 4) || (struct_len < 4)) {
+		error("DT: misaligned blocks\r\n");
+		return -1;
+	}
 
-	ret = of_get_node_offset(blob, "chosen", &nodeoffset);
-	if (ret) {
-		warning("DT: doesn't support add node (chosen)\r\n");
-		return ret;
+	/* header, reserve map, then structure and strings blocks in either order without overlap */
+	if (rsv < sizeof(boot_param_header_t) || dt_struct < rsv + 16 || dt_struct > size ||
+		struct_len > size - dt_struct || strings < rsv + 16 || strings > size || strings_len > size - strings ||
+		(strings < dt_struct + struct_len && strings + strings_len > dt_struct)) {
+		error("DT: blocks out of the blob\r\n");
+		return -1;
 	}
 
-	/*
-	 * if the property doesn't exit, add it
-	 * if the property exists, update it.
-	 */
-	ret = of_set_property(blob, nodeoffset, "bootargs", (void*)bootargs, valuelen);
-	if (ret) {
-		warning("fail to set bootargs property\r\n");
-		return ret;
+	if (swap_uint32(*(unsigned int *)of_dt_struct_offset(blob, struct_len - 4)) != OF_DT_END ||
+		(strings_len && *of_get_string_by_offset(blob, strings_len - 1) != '\0')) {
+		error("DT: blocks not terminated\r\n");
+		return -1;
 	}
 
 	return 0;
 }
 
-/* The /chosen node
- * property "linux,initrd-start" and "linux,initrd-end"
+/* Validate a blob in a buffer of capacity bytes and extend its total_size once by headroom,
+ * so it can be edited in place up to there.
  */
-int fdt_update_initrd(void *blob, uint32_t start, uint32_t end)
+int fdt_open(fdt_t *fdt, void *blob, unsigned int capacity, unsigned int headroom)
 {
-	int			 nodeoffset;
-	unsigned int data;
-	int			 ret;
+	if (fdt_check_header(blob, capacity))
+		return -1;
 
-	ret = of_get_node_offset(blob, "chosen", &nodeoffset);
-	if (ret) {
-		debug("DT: doesn't support add node (chosen)\r\n");
-		return ret;
-	}
+	fdt->blob	  = blob;
+	fdt->capacity = capacity;
+	fdt->headroom = headroom;
 
-	data = swap_uint32(start);
-	ret	 = of_set_property(blob, nodeoffset, "linux,initrd-start", &data, sizeof(data));
-	if (ret) {
-		warning("DT: could not set linux,initrd-start property\r\n");
-		return ret;
-	}
+	if (fdt_get_total_size(blob) < of_blob_data_size(blob) + headroom)
+		of_set_dt_total_size(blob, min(of_blob_data_size(blob) + headroom, capacity));
 
-	data = swap_uint32(end);
-	ret	 = of_set_property(blob, nodeoffset, "linux,initrd-end", &data, sizeof(data));
-	if (ret) {
-		warning("DT: could not set linux,initrd-end property\r\n");
-		return ret;
-	}
+	debug("DT: %u bytes, %u free\r\n", of_blob_data_size(blob), fdt_get_total_size(blob) - of_blob_data_size(blob));
 
 	return 0;
 }
 
+/* The /chosen node
+ * property "bootargs": This zero-terminated string is passed
+ * as the kernel command line.
+ */
+int fdt_update_bootargs(fdt_txn_t *txn, const char *bootargs)
+{
+	return fdt_txn_set_string(txn, "/chosen", "bootargs", bootargs);
+}
+
+/* The /chosen node
+ * property "linux,initrd-start" and "linux,initrd-end"
+ */
+int fdt_update_initrd(fdt_txn_t *txn, uint32_t start, uint32_t end)
+{
+	if (fdt_txn_set_cells(txn, "/chosen", "linux,initrd-start", &start, 1))
+		return -1;
+
+	return fdt_txn_set_cells(txn, "/chosen", "linux,initrd-end", &end, 1);
+}
+
 /* The /memory node
  * Required properties:
  * - device_type: has to be "memory".
  * - reg: this property contains all the physical memory ranges of your boards.
+ * reg holds count (base, size) pairs, one cell each.
  */
-int fdt_update_memory(void *blob, unsigned int mem_bank, unsigned int mem_size)
+int fdt_update_memory(fdt_txn_t *txn, const uint32_t *reg, unsigned int count)
 {
-	int			 nodeoffset;
-	unsigned int data[4];
-	int			 valuelen;
-	int			 ret;
+	if (fdt_txn_set_string(txn, "/memory", "device_type", "memory"))
+		return -1;
 
-	ret = of_get_node_offset(blob, "memory", &nodeoffset);
-	if (ret) {
-		warning("DT: doesn't support add node (memory)\r\n");
-		return ret;
-	}
+	return fdt_txn_set_cells(txn, "/memory", "reg", reg, count * 2);
+}
 
-	/*
-	 * if the property doesn't exit, add it
-	 * if the property exists, update it.
-	 */
-	/* set "device_type" property */
-	ret = of_set_property(blob, nodeoffset, "device_type", "memory", sizeof("memory"));
-	if (ret) {
-		warning("DT: could not set device_type property\r\n");
-		return ret;
+/* The /reserved-memory node
+ * A no-map child per region, named name@base. The node is created with one
+ * address and one size cell when missing, an existing one must use the same.
+ */
+int fdt_add_reserved_memory(fdt_txn_t *txn, void *blob, const char *name, uint32_t base, uint32_t size)
+{
+	static const char hex[] = "0123456789abcdef";
+	char			  path[OF_MAX_PATH];
+	const void		 *cells;
+	uint32_t		  reg[2];
+	unsigned int	  len;
+	int				  offset, shift;
+
+	offset = fdt_path_offset(txn, blob, "/reserved-memory");
+	if (offset < 0) {
+		reg[0] = 1;
+		if (fdt_txn_set_cells(txn, "/reserved-memory", "#address-cells", reg, 1) ||
+			fdt_txn_set_cells(txn, "/reserved-memory", "#size-cells", reg, 1) ||
+			fdt_txn_set(txn, "/reserved-memory", "ranges", NULL, 0))
+			return -1;
+	} else {
+		cells = fdt_getprop(blob, offset, "#address-cells", &len);
+		if (!cells || len != 4 || of_read_cell(cells) != 1)
+			return -1;
+		cells = fdt_getprop(blob, offset, "#size-cells", &len);
+		if (!cells || len != 4 || of_read_cell(cells) != 1)
+			return -1;
 	}
 
-	/* set "reg" property */
-	data[0]	 = swap_uint32(mem_bank);
-	data[1]	 = swap_uint32(mem_size);
-	valuelen = 8;
-	ret		 = of_set_property(blob, nodeoffset, "reg", data, valuelen);
-	if (ret) {
-		warning("DT: could not set reg property\r\n");
-		return ret;
-	}
+	len = strlen(name);
+	if (len + sizeof("/reserved-memory/@12345678") > sizeof(path))
+		return -1;
+	strcpy(path, "/reserved-memory/");
+	strcat(path, name);
+	len = strlen(path);
+	path[len++] = '@';
+	for (shift = 28; shift > 0 && !(base >> shift); shift -= 4)
+		;
+	for (; shift >= 0; shift -= 4)
+		path[len++] = hex[(base >> shift) & 0xf];
+	path[len] = '\0';
+
+	reg[0] = base;
+	reg[1] = size;
+	if (fdt_txn_set_cells(txn, path, "reg", reg, 2))
+		return -1;
 
-	return 0;
+	return fdt_txn_set(txn, path, "no-map", NULL, 0);
 }
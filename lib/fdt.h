@@ -26,9 +26,99 @@ typedef struct {
 	unsigned int dt_struct_len;
 } boot_param_header_t;
 
+/* A blob and the room it may grow into */
+typedef struct {
+	void		*blob;
+	unsigned int capacity;
+	unsigned int headroom; /* padding kept after the data when rewritten */
+} fdt_t;
+
+#define OF_MAX_DEPTH 16
+#define OF_MAX_PATH	 256
+
+/* A queued property edit, node paths ignore unit addresses ("/memory" matches "/memory@40000000") */
+typedef struct fdt_edit {
+	struct fdt_edit *next;
+	const char		*path;
+	const char		*name;
+	const void		*value;
+	unsigned int	 len;
+	unsigned int	 hash; /* path hash without unit addresses */
+	unsigned int	 depth;
+	unsigned char	 active; /* the walk is inside the target node */
+	unsigned char	 done;
+} fdt_edit_t;
+
+/* Node of the lookup index, in document order */
+typedef struct {
+	unsigned int offset;
+	unsigned int parent; /* the root is its own parent */
+	unsigned int hash;	 /* path hash without unit addresses */
+	unsigned int phandle;
+} fdt_node_t;
+
+/* Built in one walk of the blob on the first lookup */
+typedef struct {
+	void		 *blob;
+	fdt_node_t	 *nodes;
+	unsigned int  count;
+	unsigned int *paths;	/* node index + 1 by path hash */
+	unsigned int *phandles; /* node index + 1 by phandle */
+	unsigned int  mask;
+	unsigned int  max_phandle;
+} fdt_index_t;
+
+/* Phandles of the nodes added by overlays */
+typedef struct fdt_phandle {
+	struct fdt_phandle *next;
+	unsigned int		phandle;
+	const char		   *path;
+} fdt_phandle_t;
+
+/* Labels added by the overlays applied so far */
+typedef struct fdt_symbol {
+	struct fdt_symbol *next;
+	const char		  *label;
+	const char		  *path;
+} fdt_symbol_t;
+
+/* Edits are collected in the arena and applied to the blob in one pass by fdt_txn_commit() */
+typedef struct {
+	unsigned char *arena;
+	unsigned int   size;
+	unsigned int   used;
+	unsigned int   count;
+	fdt_edit_t	  *first;
+	fdt_edit_t	  *last;
+
+	/* lookups in the base tree, and what overlays added to it */
+	fdt_index_t	   index;
+	fdt_phandle_t *phandles;
+	fdt_symbol_t  *symbols;
+	unsigned int   max_phandle;
+} fdt_txn_t;
+
 unsigned int fdt_get_total_size(void *blob);
 int			 fdt_check_blob_valid(void *blob);
-int			 fdt_update_bootargs(void *blob, const char *bootargs);
-int			 fdt_update_initrd(void *blob, uint32_t start, uint32_t end);
-int			 fdt_update_memory(void *blob, unsigned int mem_bank, unsigned int mem_size);
+int			 fdt_check_header(void *blob, unsigned int capacity);
+int			 fdt_open(fdt_t *fdt, void *blob, unsigned int capacity, unsigned int headroom);
+
+void fdt_txn_init(fdt_txn_t *txn, void *arena, unsigned int size);
+int	 fdt_txn_set(fdt_txn_t *txn, const char *path, const char *name, const void *value, unsigned int len);
+int	 fdt_txn_add_node(fdt_txn_t *txn, const char *path);
+int	 fdt_txn_set_string(fdt_txn_t *txn, const char *path, const char *name, const char *string);
+int	 fdt_txn_set_cells(fdt_txn_t *txn, const char *path, const char *name, const uint32_t *cells, unsigned int count);
+int	 fdt_txn_commit(fdt_txn_t *txn, fdt_t *src, fdt_t *dst);
+int	 fdt_overlay_apply(fdt_txn_t *txn, void *blob, void *overlay);
+
+int			fdt_path_offset(fdt_txn_t *txn, void *blob, const char *path);
+int			fdt_node_offset_by_phandle(fdt_txn_t *txn, void *blob, unsigned int phandle);
+int			fdt_node_offset_by_compatible(void *blob, int startoffset, const char *compatible);
+int			fdt_get_path(fdt_txn_t *txn, void *blob, int nodeoffset, char *buf, unsigned int size);
+const void *fdt_getprop(void *blob, int nodeoffset, const char *name, unsigned int *len);
+
+int fdt_update_bootargs(fdt_txn_t *txn, const char *bootargs);
+int fdt_update_initrd(fdt_txn_t *txn, uint32_t start, uint32_t end);
+int fdt_update_memory(fdt_txn_t *txn, const uint32_t *reg, unsigned int count);
+int fdt_add_reserved_memory(fdt_txn_t *txn, void *blob, const char *name, uint32_t base, uint32_t size);
 #endif /* #ifndef __FDT_H__ */
@@ -2,16 +2,21 @@ LIB := lib
 
 INCLUDE_DIRS += -I $(LIB)
 
-USE_SDMMC = $(shell grep -E "^\#define CONFIG_BOOT_(SDCARD|MMC)" board.h)
+# Config files on the FAT partition
+SDMMC_SRCS	+=  $(LIB)/bootconf.c
 
-ifneq ($(USE_SDMMC),)
-SRCS	+=  $(LIB)/bootconf.c
 SRCS	+=  $(LIB)/loaders.c
-endif
-
 SRCS	+=  $(LIB)/fdt.c
+SRCS	+=  $(LIB)/cmdline.c
 SRCS	+=  $(LIB)/debug.c
 SRCS	+=  $(LIB)/string.c
 SRCS	+=  $(LIB)/xformat.c
 
+# Run from DRAM once it is up, see link.ld. Only code called after
+# sunxi_dram_init() belongs here, logging and string helpers stay in SRAM.
+DRAM_SRCS	+=  $(LIB)/bootconf.c
+DRAM_SRCS	+=  $(LIB)/loaders.c
+DRAM_SRCS	+=  $(LIB)/fdt.c
+DRAM_SRCS	+=  $(LIB)/cmdline.c
+
 include lib/fatfs/fatfs.mk
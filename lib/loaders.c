@@ -1,6 +1,8 @@
 #include "common.h"
 #include "loaders.h"
 #include "board.h"
+#include "fdt.h"
+#include "sdmmc.h"
 
 #if defined(CONFIG_BOOT_SDCARD) || defined(CONFIG_BOOT_MMC)
 
@@ -82,6 +84,157 @@ close:
 	return ret;
 }
 
+/* Read a whole file of at most size bytes */
+int read_file_max(const char *filename, uint8_t *dest, unsigned int size)
+{
+	FIL		file;
+	UINT	bytes_read = 0;
+	FRESULT fret;
+
+	if (!filename) {
+		error("FATFS: empty filename\r\n");
+		return -1;
+	}
+
+	fret = f_open(&file, filename, FA_OPEN_EXISTING | FA_READ);
+	if (fret != FR_OK) {
+		debug("FATFS: file open: [%s]: error %d\r\n", filename, fret);
+		return -1;
+	}
+
+	if (f_size(&file) > size) {
+		error("FATFS: %s is larger than %u bytes\r\n", filename, size);
+		f_close(&file);
+		return -1;
+	}
+
+	fret = f_read(&file, dest, size, &bytes_read);
+	f_close(&file);
+	if (fret != FR_OK) {
+		error("FATFS: file read error %d\r\n", fret);
+		return -1;
+	}
+
+	return (int)bytes_read;
+}
+
+/*
+  Read the overlays listed in image->overlays back to back at image->overlay_dest
+*/
+static int load_overlays(image_info_t *image)
+{
+	char		   name[MAX_FILENAME_SIZE];
+	const char	   *p	 = image->overlays;
+	unsigned char *dest = image->overlay_dest;
+	unsigned int   len;
+	int			   ret;
+
+	image->overlay_count = 0;
+
+	while (*p) {
+		while (*p == ' ' || *p == ',' || *p == '\t')
+			p++;
+		for (len = 0; p[len] && p[len] != ' ' && p[len] != ',' && p[len] != '\t'; len++)
+			;
+		if (len == 0)
+			break;
+		if (len >= MAX_FILENAME_SIZE) {
+			error("FATFS: overlay name too long\r\n");
+			return -1;
+		}
+		memcpy(name, p, len);
+		name[len] = '\0';
+		p += len;
+
+		if (dest >= image->overlay_dest + CONFIG_DTBO_MAX_SIZE) {
+			error("FATFS: overlays exceed %u bytes\r\n", CONFIG_DTBO_MAX_SIZE);
+			return -1;
+		}
+
+		info("FATFS: read %s addr=%x\r\n", name, (unsigned int)dest);
+		ret = read_file_max(name, dest, image->overlay_dest + CONFIG_DTBO_MAX_SIZE - dest);
+		if (ret <= 0)
+			return -1;
+		// main() steps to the next overlay by its total size
+		if (fdt_check_blob_valid(dest) != 0 || fdt_get_total_size(dest) != (unsigned int)ret) {
+			error("FATFS: %s is not a valid overlay\r\n", name);
+			return -1;
+		}
+
+		dest += ALIGN(ret, 8);
+		image->overlay_count++;
+	}
+
+	return 0;
+}
+
+static u8 part_sector[512];
+
+static u32 part_le32(const u8 *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32)p[3] << 24);
+}
+
+// Hex bytes in the given order, as in the textual UUIDs
+static char *part_hex(char *p, const u8 *bytes, const char *order)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	for (; *order; order++) {
+		if (*order == '-') {
+			*p++ = '-';
+			continue;
+		}
+		*p++ = hex[bytes[*order - 'a'] >> 4];
+		*p++ = hex[bytes[*order - 'a'] & 0xf];
+	}
+
+	return p;
+}
+
+/* PARTUUID of partition part (from 1) as the kernel names it,
+ * SSSSSSSS-PP on MBR disks, the partition GUID on GPT ones.
+ */
+int sdmmc_get_partuuid(unsigned int part, char *buf)
+{
+	const u8 *entry;
+	u8		  sig[4], num = part;
+	u32		  lba, count, size;
+
+	if (part == 0 || sdmmc_blk_read(&card0, part_sector, 0, 1) != 1)
+		return -1;
+	if (part_sector[510] != 0x55 || part_sector[511] != 0xaa)
+		return -1;
+
+	// Protective MBR
+	if (part_sector[446 + 4] != 0xee) {
+		if (part > 4 || part_sector[446 + (part - 1) * 16 + 4] == 0)
+			return -1;
+		*part_hex(part_hex(buf, &part_sector[440], "dcba-"), &num, "a") = '\0';
+		return 0;
+	}
+
+	if (sdmmc_blk_read(&card0, part_sector, 1, 1) != 1 || memcmp(part_sector, "EFI PART", 8))
+		return -1;
+	lba	  = part_le32(&part_sector[72]);
+	count = part_le32(&part_sector[80]);
+	size  = part_le32(&part_sector[84]);
+	if (part > count || size < 128 || size > sizeof(part_sector) || (sizeof(part_sector) % size))
+		return -1;
+
+	lba += (part - 1) / (sizeof(part_sector) / size);
+	if (sdmmc_blk_read(&card0, part_sector, lba, 1) != 1)
+		return -1;
+	entry = &part_sector[((part - 1) % (sizeof(part_sector) / size)) * size];
+
+	memset(sig, 0, sizeof(sig));
+	if (!memcmp(entry, sig, sizeof(sig)) && !memcmp(entry + 4, sig, sizeof(sig)))
+		return -1; // unused entry
+	*part_hex(buf, entry + 16, "dcba-fe-hg-ij-klmnop") = '\0';
+
+	return 0;
+}
+
 int load_sdmmc(image_info_t *image)
 {
 	int ret;
@@ -99,16 +252,17 @@ int load_sdmmc(image_info_t *image)
 	start = time_ms();
 
 	info("FATFS: read %s addr=%x\r\n", image->dtb_filename, (unsigned int)image->dtb_dest);
-	ret = read_file(image->dtb_filename, image->dtb_dest);
+	// The headroom is kept free for in place edits, the overlays follow
+	ret = read_file_max(image->dtb_filename, image->dtb_dest, CONFIG_DTB_MAX_SIZE - CONFIG_DTB_HEADROOM);
 	if (ret <= 0)
 		return ret;
-	image->kernel_size = ret;
+	image->dtb_size = ret;
 
 	info("FATFS: read %s addr=%x\r\n", image->filename, (unsigned int)image->kernel_dest);
 	ret = read_file(image->filename, image->kernel_dest);
 	if (ret <= 0)
 		return ret;
-	image->dtb_size = ret;
+	image->kernel_size = ret;
 
 	if (image->initrd_filename && image->initrd_dest) {
 		if (strlen(image->initrd_filename)) {
@@ -120,6 +274,12 @@ int load_sdmmc(image_info_t *image)
 		}
 	}
 
+	if (image->overlays && image->overlay_dest) {
+		ret = load_overlays(image);
+		if (ret < 0)
+			return ret;
+	}
+
 	debug("FATFS: done in %ums\r\n", time_ms() - start);
 
 	return 0;
@@ -138,12 +298,16 @@ int load_spi_nand(sunxi_spi_t *spi, image_info_t *image)
 
 	/* get dtb size and read */
 	spi_nand_read(spi, image->dtb_dest, CONFIG_SPINAND_DTB_ADDR, (uint32_t)sizeof(boot_param_header_t));
-	if (of_get_magic_number(image->dtb_dest) != OF_DT_MAGIC) {
+	if (fdt_check_blob_valid(image->dtb_dest) != 0) {
 		error("SPI-NAND: DTB verification failed\r\n");
 		return -1;
 	}
 
 	size = fdt_get_total_size(image->dtb_dest);
+	if (size > CONFIG_DTB_MAX_SIZE) {
+		error("SPI-NAND: DTB too large (%u bytes)\r\n", size);
+		return -1;
+	}
 	debug("SPI-NAND: dt blob: Copy from 0x%08x to 0x%08lx size:0x%08x\r\n", CONFIG_SPINAND_DTB_ADDR,
 		  (uint32_t)image->dtb_dest, size);
 	start = time_us();
@@ -169,3 +333,53 @@ int load_spi_nand(sunxi_spi_t *spi, image_info_t *image)
 	return 0;
 }
 #endif
+
+#ifdef CONFIG_BOOT_SPINOR
+int load_spi_nor(sunxi_spi_t *spi, image_info_t *image)
+{
+	linux_zimage_header_t *hdr;
+	unsigned int		   size;
+	uint64_t			   start, time;
+
+	if (spi_nor_detect(spi) != 0)
+		return -1;
+
+	/* get dtb size and read */
+	spi_nor_read(spi, image->dtb_dest, CONFIG_SPINOR_DTB_ADDR, (uint32_t)sizeof(boot_param_header_t));
+	if (fdt_check_blob_valid(image->dtb_dest) != 0) {
+		error("SPI-NOR: DTB verification failed\r\n");
+		return -1;
+	}
+
+	size = fdt_get_total_size(image->dtb_dest);
+	if (size > CONFIG_DTB_MAX_SIZE) {
+		error("SPI-NOR: DTB too large (%u bytes)\r\n", size);
+		return -1;
+	}
+	debug("SPI-NOR: dt blob: Copy from 0x%08x to 0x%08lx size:0x%08x\r\n", CONFIG_SPINOR_DTB_ADDR,
+		  (uint32_t)image->dtb_dest, size);
+	start = time_us();
+	if (spi_nor_read(spi, image->dtb_dest, CONFIG_SPINOR_DTB_ADDR, (uint32_t)size) != size)
+		return -1;
+	time = time_us() - start;
+	info("SPI-NOR: read dt blob of size %u at %.2fMB/S\r\n", size, (f32)(size / time));
+
+	/* get kernel size and read it in a single transfer */
+	spi_nor_read(spi, image->kernel_dest, CONFIG_SPINOR_KERNEL_ADDR, (uint32_t)sizeof(linux_zimage_header_t));
+	hdr = (linux_zimage_header_t *)image->kernel_dest;
+	if (hdr->magic != LINUX_ZIMAGE_MAGIC) {
+		debug("SPI-NOR: zImage verification failed\r\n");
+		return -1;
+	}
+	size = hdr->end - hdr->start;
+	debug("SPI-NOR: Image: Copy from 0x%08x to 0x%08lx size:0x%08x\r\n", CONFIG_SPINOR_KERNEL_ADDR,
+		  (uint32_t)image->kernel_dest, size);
+	start = time_us();
+	if (spi_nor_read(spi, image->kernel_dest, CONFIG_SPINOR_KERNEL_ADDR, (uint32_t)size) != size)
+		return -1;
+	time = time_us() - start;
+	info("SPI-NOR: read Image of size %u at %.2fMB/S\r\n", size, (f32)(size / time));
+
+	return 0;
+}
+#endif
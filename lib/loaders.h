@@ -4,14 +4,22 @@
 #include "board.h"
 
 #if defined(CONFIG_BOOT_SDCARD) || defined(CONFIG_BOOT_MMC)
+#define PARTUUID_SIZE 37 // GUID and terminator
+
 int	 mount_sdmmc(void);
 void unmount_sdmmc(void);
 int	 read_file(const char *filename, uint8_t *dest);
+int	 read_file_max(const char *filename, uint8_t *dest, unsigned int size);
 int	 load_sdmmc(image_info_t *image);
+int	 sdmmc_get_partuuid(unsigned int part, char *buf);
 #endif
 
 #ifdef CONFIG_BOOT_SPINAND
 int load_spi_nand(sunxi_spi_t *spi, image_info_t *image);
 #endif
 
+#ifdef CONFIG_BOOT_SPINOR
+int load_spi_nor(sunxi_spi_t *spi, image_info_t *image);
+#endif
+
 #endif
@@ -3,18 +3,28 @@
 #include "sunxi_clk.h"
 #include "sunxi_wdg.h"
 #include "sdmmc.h"
+#include "sunxi_dma.h"
 #include "arm32.h"
 #include "debug.h"
 #include "board.h"
 #include "barrier.h"
 #include "bootconf.h"
 #include "loaders.h"
+#include "cmdline.h"
+#include "memtest.h"
 
 image_info_t image;
 
-static char	  cmd_line[128];
-static char	  filename[16];
-static slot_t slot;
+static const char *kernel_args;
+static char		   filename[16];
+static slot_t	   slot;
+static cmdline_t   cmdline;
+static fdt_txn_t   fdt_txn;
+static fdt_t	 dtb;
+static fdt_t	 dtb_fixup = {(void *)CONFIG_DTB_FIXUP_ADDR, CONFIG_DTB_FIXUP_SIZE, CONFIG_DTB_HEADROOM};
+#ifdef CONFIG_DRAM_MEMTEST
+static memtest_result_t memtest;
+#endif
 
 static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 {
@@ -30,6 +40,138 @@ static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 	return -1;
 }
 
+/* One /memory bank per rank and what init_DRAM() measured under /chosen */
+static int fdt_update_dram(fdt_txn_t *txn, void *blob, uint32_t memory_size)
+{
+	const dram_info_t *info = sunxi_dram_get_info();
+	uint32_t		   reg[4], val[2];
+	unsigned int	   banks = 1;
+
+	reg[0] = SDRAM_BASE;
+	reg[1] = memory_size;
+	if (info->size_mb && info->ranks == 2 && info->rank_mb[1]) {
+		reg[1] = MB(info->rank_mb[0]);
+		reg[2] = SDRAM_BASE + reg[1];
+		reg[3] = MB(info->rank_mb[1]);
+		banks  = 2;
+	}
+	if (fdt_update_memory(txn, reg, banks))
+		return -1;
+
+	if (info->size_mb) {
+		const struct {
+			const char	*name;
+			unsigned int value;
+		} props[] = {
+			{"type", info->type},
+			{"clock-frequency", info->clk * 1000000},
+			{"ranks", info->ranks},
+			{"bus-width", info->width},
+			{"banks", info->banks},
+			{"row-bits", info->row_bits},
+			{"page-size", info->page_size},
+		};
+		const uint32_t para2[]		 = {info->para2};
+		const uint32_t eye_delay[]	 = {info->eye_delay[0], info->eye_delay[1], info->eye_delay[2]};
+		const uint32_t gate_status[] = {info->gate_status[0], info->gate_status[1]};
+		const struct {
+			const char	   *name;
+			const uint32_t *cells;
+			unsigned int	count;
+		} training[] = {
+			{"para2", para2, ARRAY_SIZE(para2)},
+			{"eye-delay", eye_delay, ARRAY_SIZE(eye_delay)},
+			{"gate-status", gate_status, ARRAY_SIZE(gate_status)},
+		};
+		unsigned int i;
+
+		if (fdt_txn_set_string(txn, "/chosen/awboot,dram", "compatible", "awboot,dram"))
+			return -1;
+		for (i = 0; i < ARRAY_SIZE(props); i++) {
+			val[0] = props[i].value;
+			if (fdt_txn_set_cells(txn, "/chosen/awboot,dram", props[i].name, val, 1))
+				return -1;
+		}
+		val[0] = info->rank_mb[0];
+		val[1] = info->rank_mb[1];
+		if (fdt_txn_set_cells(txn, "/chosen/awboot,dram", "rank-sizes-mb", val, info->ranks))
+			return -1;
+
+		// Timing profile and training results
+		if (fdt_txn_set_string(txn, "/chosen/awboot,dram", "profile", info->profile))
+			return -1;
+		for (i = 0; i < ARRAY_SIZE(training); i++) {
+			if (fdt_txn_set_cells(txn, "/chosen/awboot,dram", training[i].name, training[i].cells, training[i].count))
+				return -1;
+		}
+	}
+
+#ifdef CONFIG_DRAM_MEMTEST
+	{
+		const uint32_t results[] = {memtest.modes, memtest.size_mb, memtest.errors};
+		const uint32_t first[]	 = {memtest.first_addr, memtest.first_expected, memtest.first_actual};
+
+		if (fdt_txn_set_cells(txn, "/chosen/awboot,dram", "memtest-modes", &results[0], 1) ||
+			fdt_txn_set_cells(txn, "/chosen/awboot,dram", "memtest-size-mb", &results[1], 1) ||
+			fdt_txn_set_cells(txn, "/chosen/awboot,dram", "memtest-errors", &results[2], 1))
+			return -1;
+		if (memtest.errors && fdt_txn_set_cells(txn, "/chosen/awboot,dram", "memtest-first-error", first, 3))
+			return -1;
+	}
+#endif
+
+#if defined(CONFIG_FATFS_CACHE_SIZE) && defined(CONFIG_FATFS_CACHE_RESERVE)
+	if (fdt_add_reserved_memory(txn, blob, "awboot-fatfs-cache", SDRAM_BASE, CONFIG_FATFS_CACHE_SIZE))
+		return -1;
+#else
+	(void)blob;
+#endif
+
+	return 0;
+}
+
+/* The DTB bootargs then the slot ones, with the runtime variables expanded */
+static int fdt_update_cmdline(fdt_txn_t *txn, void *blob, char slot_name, uint32_t boot_count, uint32_t memory_size)
+{
+	const char	*bootargs = NULL;
+	unsigned int len	  = 0;
+	int			 offset;
+#if defined(CONFIG_BOOT_SDCARD) || defined(CONFIG_BOOT_MMC)
+	char partuuid[PARTUUID_SIZE];
+#endif
+
+	cmdline_init(&cmdline, (char *)CONFIG_CMDLINE_ADDR, CONFIG_CMDLINE_SIZE);
+	cmdline_set_var(&cmdline, "slot", "%c", slot_name);
+	cmdline_set_var(&cmdline, "boot_count", "%" PRIu32, boot_count);
+	cmdline_set_var(&cmdline, "dram_mb", "%" PRIu32, memory_size >> 20);
+#if defined(CONFIG_BOOT_SDCARD) || defined(CONFIG_BOOT_MMC)
+	if (slot.root_part) {
+		if (sdmmc_get_partuuid(slot.root_part, partuuid) != 0) {
+			error("BOOT: no PARTUUID for partition %u\r\n", slot.root_part);
+		} else {
+			cmdline_set_var(&cmdline, "root_partuuid", "%s", partuuid);
+		}
+	}
+#endif
+
+	if (blob) {
+		offset = fdt_path_offset(txn, blob, "/chosen");
+		if (offset >= 0)
+			bootargs = fdt_getprop(blob, offset, "bootargs", &len);
+		if (bootargs && len && bootargs[len - 1] == '\0')
+			cmdline_append(&cmdline, bootargs);
+	}
+	if (kernel_args)
+		cmdline_append(&cmdline, kernel_args);
+
+	if (cmdline.len == 0)
+		return 0;
+
+	debug("BOOT: args %s\r\n", cmdline.buf);
+
+	return fdt_update_bootargs(txn, cmdline.buf);
+}
+
 #if defined(CONFIG_BOOT_SDCARD) || defined(CONFIG_BOOT_MMC)
 #define CHUNK_SIZE 0x20000
 
@@ -78,6 +220,27 @@ open_fail:
 }
 #endif
 
+/* DRAM_SRCS code, linked in DRAM and loaded after the SRAM image, see link.ld */
+extern u8 __dram_code_start[], __dram_code_end[], __dram_code_load[];
+extern u8 __dram_bss_start[], __dram_bss_end[];
+
+static void dram_code_load(uint32_t memory_size)
+{
+	if (memory_size == 0)
+		fatal("DRAM: init failed\r\n");
+	if ((uint32_t)__dram_bss_end > SDRAM_BASE + memory_size)
+		fatal("DRAM: code at 0x%x needs more than %" PRIu32 "MB\r\n", (u32)__dram_code_start, memory_size >> 20);
+
+	memcpy(__dram_code_start, __dram_code_load, __dram_code_end - __dram_code_start);
+	memset(__dram_bss_start, 0, __dram_bss_end - __dram_bss_start);
+
+	// Fetches from DRAM are slow without it, the MMU stays off
+	arm32_icache_invalidate();
+	arm32_icache_enable();
+
+	debug("DRAM: %u bytes of code at 0x%x\r\n", (u32)(__dram_code_end - __dram_code_start), (u32)__dram_code_start);
+}
+
 int main(void)
 {
 	unsigned int entry_point = 0;
@@ -86,10 +249,13 @@ int main(void)
 	uint32_t	 wait	   = 0;
 	char		 slot_name = 'R';
 	uint8_t		 slot_num  = 0;
-	uint8_t		 slot_boots[3];
-	bool		 slot_valid[3];
-	char		 slots[3]	 = {'R', 'A', 'B'};
+#if defined(CONFIG_BOOT_SDCARD) || defined(CONFIG_BOOT_MMC)
+	uint8_t slot_boots[3];
+	bool	slot_valid[3];
+	char	slots[3] = {'R', 'A', 'B'};
+#endif
 	uint8_t		 btn_led_val = false;
+	u8			*overlay;
 	sunxi_clk_init();
   board_init();
 
@@ -100,6 +266,23 @@ int main(void)
 
 	memory_size = sunxi_dram_init();
 
+#ifdef CONFIG_DRAM_MEMTEST
+	if (CONFIG_DRAM_MEMTEST_MB && CONFIG_DRAM_MEMTEST_MB < (memory_size >> 20))
+		memtest_run(SDRAM_BASE, CONFIG_DRAM_MEMTEST_MB, CONFIG_DRAM_MEMTEST, &memtest);
+	else
+		memtest_run(SDRAM_BASE, memory_size >> 20, CONFIG_DRAM_MEMTEST, &memtest);
+#endif
+
+	// After the memory test, it may overwrite the whole DRAM
+	dram_code_load(memory_size);
+
+	// Used for SPI transfers and large memory copies
+	dma_init();
+
+#ifdef CONFIG_DMA_MEMCPY_BENCH
+	dma_memcpy_bench(memory_size);
+#endif
+
 	void (*kernel_entry)(int zero, int arch, unsigned int params);
 
 #ifdef CONFIG_ENABLE_CPU_FREQ_DUMP
@@ -154,9 +337,10 @@ int main(void)
 
 	memset(&image, 0, sizeof(image_info_t));
 
-	image.dtb_dest	  = (u8 *)CONFIG_DTB_LOAD_ADDR;
-	image.kernel_dest = (u8 *)CONFIG_KERNEL_LOAD_ADDR;
-	image.initrd_dest = (u8 *)CONFIG_INITRAMFS_LOAD_ADDR;
+	image.dtb_dest	   = (u8 *)CONFIG_DTB_LOAD_ADDR;
+	image.kernel_dest  = (u8 *)CONFIG_KERNEL_LOAD_ADDR;
+	image.initrd_dest  = (u8 *)CONFIG_INITRAMFS_LOAD_ADDR;
+	image.overlay_dest = (u8 *)CONFIG_DTBO_LOAD_ADDR;
 
 // Normal media boot
 #if defined(CONFIG_BOOT_SDCARD) || defined(CONFIG_BOOT_MMC)
@@ -167,18 +351,21 @@ int main(void)
 		info("SMHC: %s controller v%" PRIx32 " initialized\r\n", sdhci0.name, sdhci0.reg->vers);
 	}
 	if (sdmmc_init(&card0, &sdhci0) != 0) {
-#ifdef CONFIG_BOOT_SPINAND
+#if defined(CONFIG_BOOT_SPINAND) || defined(CONFIG_BOOT_SPINOR)
 		warning("SMHC: init failed, trying SPI\r\n");
 		goto _spi;
 #else
 		fatal("SMHC: init failed\r\n");
-	}
 #endif
+	}
 
 		if (mount_sdmmc() != 0) {
 			fatal("SMHC: card mount failed\r\n");
 		};
 
+		// Everything below comes from this sector when present
+		bootconf_load_bin(CONFIG_CONF_BIN_FILENAME);
+
 		strcpy(filename + 1, ".state");
 
 		// Check both normal slots for validity
@@ -274,15 +461,20 @@ int main(void)
 
 		image.initrd_size = 0; // Set by load_sdmmc()
 
-		strcpy(cmd_line, slot.kernel_cmd);
+		kernel_args			  = slot.kernel_cmd;
 		image.filename		  = slot.kernel_filename;
 		image.dtb_filename	  = slot.dtb_filename;
 		image.initrd_filename = slot.initrd_filename;
+		image.overlays		  = slot.overlays;
+
+		if (load_sdmmc(&image) != 0) {
+			fatal("SMHC: loading failed\r\n");
+		}
 
-#elif defined(CONFIG_BOOT_SPINAND)
+#elif defined(CONFIG_BOOT_SPINAND) || defined(CONFIG_BOOT_SPINOR)
 	// Static slot configs for SPI
 	image.initrd_size = 0; // disabled
-	strcpy(cmd_line, CONFIG_DEFAULT_BOOT_CMD);
+	kernel_args		  = CONFIG_DEFAULT_BOOT_CMD;
 
 #else // 100% Fel boot
 	info("BOOT: FEL mode\r\n");
@@ -290,29 +482,33 @@ int main(void)
 	// This value is copied via xfel
 	image.initrd_size = *(uint32_t *)(0x45000000);
 
-	strcpy(cmd_line, CONFIG_DEFAULT_BOOT_CMD);
+	kernel_args = CONFIG_DEFAULT_BOOT_CMD;
 #endif
 
 
-#ifdef CONFIG_BOOT_SPINAND
+#if defined(CONFIG_BOOT_SPINAND) || defined(CONFIG_BOOT_SPINOR)
 #if defined(CONFIG_BOOT_SDCARD) || defined(CONFIG_BOOT_MMC)
 _spi:
 #endif
-	dma_init();
 	dma_test();
 	debug("SPI: init\r\n");
 	if (sunxi_spi_init(&sunxi_spi0) != 0) {
 		fatal("SPI: init failed\r\n");
 	}
 
+#ifdef CONFIG_BOOT_SPINOR
+	if (load_spi_nor(&sunxi_spi0, &image) != 0) {
+		fatal("SPI-NOR: loading failed\r\n");
+	}
+#else
 		if (load_spi_nand(&sunxi_spi0, &image) != 0) {
 			fatal("SPI-NAND: loading failed\r\n");
 		}
+#endif
 
 	sunxi_spi_disable(&sunxi_spi0);
-	dma_exit();
 
-#endif // CONFIG_SPI_NAND
+#endif // CONFIG_BOOT_SPINAND || CONFIG_BOOT_SPINOR
 
 	if (boot_image_setup((unsigned char *)image.kernel_dest, &entry_point)) {
 		fatal("boot setup failed\r\n");
@@ -324,31 +520,53 @@ _spi:
 		// Check if we should still be running
 		if (!board_get_power_on()) {
 			info("Waiting for power off...");
+			log_flush();
 			board_set_status(0);
 			while (1) { // wait for poweroff or watchdog
 			};
 		}
 	}
 
-		if (strlen(cmd_line) > 0) {
-			debug("BOOT: args %s\r\n", cmd_line);
-			if (fdt_update_bootargs(image.dtb_dest, cmd_line)) {
+		// Check the DTB within its load area, it gets some free room after its data.
+		// The fixups only run on a valid tree, an invalid one is passed on as loaded.
+		if (fdt_open(&dtb, image.dtb_dest, CONFIG_DTB_MAX_SIZE, CONFIG_DTB_HEADROOM) != 0) {
+			error("BOOT: invalid DTB, skipping the DT fixups\r\n");
+		} else {
+			// Queue all fixups, then rebuild the DTB once into the fixup area
+			fdt_txn_init(&fdt_txn, (void *)CONFIG_FDT_ARENA_ADDR, CONFIG_FDT_ARENA_SIZE);
+
+			// Overlays first, the boot fixups below take precedence over them
+			overlay = image.overlay_dest;
+			for (i = 0; i < image.overlay_count; i++) {
+				if (fdt_overlay_apply(&fdt_txn, dtb.blob, overlay)) {
+					error("BOOT: Failed to apply overlay %" PRIu32 "\r\n", i);
+				}
+				overlay += ALIGN(fdt_get_total_size(overlay), 8);
+			}
+
+			if (fdt_update_cmdline(&fdt_txn, dtb.blob, slot_name, RTC_BKP_REG(slot_num), memory_size)) {
 				error("BOOT: Failed to set boot args\r\n");
 			}
-		}
 
-		if (fdt_update_memory(image.dtb_dest, SDRAM_BASE, memory_size)) {
-			error("BOOT: Failed to set memory size\r\n");
-		} else {
-			debug("BOOT: Set memory size to 0x%x\r\n", memory_size);
-		}
+			if (fdt_update_dram(&fdt_txn, dtb.blob, memory_size)) {
+				error("BOOT: Failed to set memory size\r\n");
+			} else {
+				debug("BOOT: Set memory size to 0x%x\r\n", memory_size);
+			}
 
-		if (image.initrd_dest) {
-			if (fdt_update_initrd(image.dtb_dest, (uint32_t)image.initrd_dest,
-								  (uint32_t)(image.initrd_dest + image.initrd_size))) {
-				error("BOOT: Failed to set initrd address\r\n");
+			if (image.initrd_dest) {
+				if (fdt_update_initrd(&fdt_txn, (uint32_t)image.initrd_dest,
+									  (uint32_t)(image.initrd_dest + image.initrd_size))) {
+					error("BOOT: Failed to set initrd address\r\n");
+				} else {
+					debug("BOOT: Set initrd to 0x%x-0x%x\r\n", image.initrd_dest, image.initrd_dest + image.initrd_size);
+				}
+			}
+
+			if (fdt_txn_commit(&fdt_txn, &dtb, &dtb_fixup)) {
+				error("BOOT: Failed to apply DT fixups, using the DTB as loaded\r\n");
 			} else {
-				debug("BOOT: Set initrd to 0x%x-0x%x\r\n", image.initrd_dest, image.initrd_dest + image.initrd_size);
+				image.dtb_dest = (u8 *)CONFIG_DTB_FIXUP_ADDR;
 			}
 		}
 
@@ -359,9 +577,12 @@ _spi:
 #endif
 
 		info("booting linux...\r\n");
+		log_flush();
 		board_set_led(LED_BOARD, 0);
 		board_set_led(LED_BUTTON, 1);
 
+		dma_exit();
+
 		arm32_mmu_disable();
 		arm32_dcache_disable();
 		arm32_icache_disable();
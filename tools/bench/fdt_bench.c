@@ -0,0 +1,191 @@
+/*
+ * lib/fdt.c on the host: times the boot fixups of main.c (bootargs, memory,
+ * initrd, reserved memory and /chosen/awboot,dram) committed into a second
+ * buffer, for each DTB on the command line.
+ *
+ * make bench DTBS="sun8i-t113-mangopi-dual.dtb ..." [FDT_SRC=old/fdt.c]
+ *
+ * fdt.c keeps addresses in unsigned int, so every buffer handed to it is
+ * static and the binary is linked -no-pie to keep them under 4GB.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+#include "fdt.h"
+
+#define DTB_MAX_SIZE (256 * 1024)
+#define DTB_HEADROOM (12 * 1024)
+#define ARENA_SIZE	 (252 * 1024)
+#define SDRAM_BASE	 0x40000000
+
+static uint8_t dtb[DTB_MAX_SIZE] __attribute__((aligned(8)));
+static uint8_t fixup[DTB_MAX_SIZE] __attribute__((aligned(8)));
+static uint8_t arena[ARENA_SIZE] __attribute__((aligned(8)));
+
+static const char bootargs[] = "console=ttyS3,115200 earlycon rootwait rw slot=a boot_count=1 dram_mb=128";
+
+void message(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+}
+
+// What main.c queues after the overlays, DRAM values of a 128MB T113-S3
+static int bench_fixups(fdt_txn_t *txn, void *blob)
+{
+	static const struct {
+		const char *name;
+		uint32_t	value;
+	} props[] = {
+		{"size-mb", 128},		{"ranks", 1},			{"type", 3},		   {"clock-mhz", 792},
+		{"odt", 1},				{"tpr10", 0x002f0007},	{"tpr11", 0x00000000}, {"tpr12", 0x00000000},
+		{"tpr13", 0x34050100},	{"mr0", 0x1c70},		{"mr1", 0x2},		   {"mr2", 0x18},
+		{"read-delay", 0x3a},	{"write-delay", 0x42},	{"memtest-modes", 3},  {"memtest-size-mb", 128},
+		{"memtest-errors", 0},
+	};
+	uint32_t	 reg[2] = {SDRAM_BASE, 128 << 20};
+	uint32_t	 ranks	= 128;
+	unsigned int i;
+
+	if (fdt_path_offset(txn, blob, "/chosen") < 0)
+		return -1;
+	if (fdt_update_bootargs(txn, bootargs) || fdt_update_memory(txn, reg, 1) ||
+		fdt_update_initrd(txn, SDRAM_BASE + (64 << 20), SDRAM_BASE + (72 << 20)))
+		return -1;
+	if (fdt_txn_set_string(txn, "/chosen/awboot,dram", "compatible", "awboot,dram") ||
+		fdt_txn_set_string(txn, "/chosen/awboot,dram", "profile", "ddr3-792"))
+		return -1;
+	for (i = 0; i < sizeof(props) / sizeof(props[0]); i++) {
+		if (fdt_txn_set_cells(txn, "/chosen/awboot,dram", props[i].name, &props[i].value, 1))
+			return -1;
+	}
+	if (fdt_txn_set_cells(txn, "/chosen/awboot,dram", "rank-sizes-mb", &ranks, 1))
+		return -1;
+
+	return fdt_add_reserved_memory(txn, blob, "awboot-fatfs-cache", SDRAM_BASE, 4 << 20);
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t fnv(uint32_t h, const void *buf, unsigned int len)
+{
+	const uint8_t *p = buf;
+
+	while (len--)
+		h = (h ^ *p++) * 16777619U;
+	return h;
+}
+
+// FNV-1a of the tree with the property names in place of their string offsets,
+// equal across fdt.c versions that lay out the strings block differently
+static uint32_t tree_hash(const uint8_t *blob)
+{
+	const uint8_t *p	   = blob + be32(blob + 8);
+	const uint8_t *end	   = p + be32(blob + 36);
+	const char	  *strings = (const char *)blob + be32(blob + 12);
+	uint32_t	   h	   = 2166136261U, token, len;
+
+	while (p < end) {
+		token = be32(p);
+		h	  = fnv(h, p, 4);
+		p += 4;
+		if (token == 1) {
+			len = strlen((const char *)p) + 1;
+			h	= fnv(h, p, len);
+			p += (len + 3) & ~3;
+		} else if (token == 3) {
+			len = be32(p);
+			h	= fnv(h, strings + be32(p + 4), strlen(strings + be32(p + 4)));
+			h	= fnv(h, p + 8, len);
+			p += 8 + ((len + 3) & ~3);
+		} else if (token == 9) {
+			break;
+		}
+	}
+	return h;
+}
+
+static int bench(const char *path, unsigned int loops)
+{
+	fdt_t		 src, dst = {fixup, sizeof(fixup), DTB_HEADROOM};
+	fdt_txn_t	 txn;
+	FILE		*file;
+	size_t		 size;
+	uint64_t	 start, best = UINT64_MAX, total = 0;
+	unsigned int i;
+
+	file = fopen(path, "rb");
+	if (!file) {
+		perror(path);
+		return -1;
+	}
+	size = fread(dtb, 1, sizeof(dtb), file);
+	fclose(file);
+
+	if (fdt_open(&src, dtb, sizeof(dtb), DTB_HEADROOM)) {
+		fprintf(stderr, "%s: invalid DTB\n", path);
+		return -1;
+	}
+
+	for (i = 0; i < loops; i++) {
+		start = now_ns();
+		fdt_txn_init(&txn, arena, sizeof(arena));
+		if (bench_fixups(&txn, src.blob) || fdt_txn_commit(&txn, &src, &dst)) {
+			fprintf(stderr, "%s: fixups failed\n", path);
+			return -1;
+		}
+		start = now_ns() - start;
+		total += start;
+		if (start < best)
+			best = start;
+	}
+
+	if (fdt_check_header(fixup, sizeof(fixup))) {
+		fprintf(stderr, "%s: invalid fixed up DTB\n", path);
+		return -1;
+	}
+
+	printf("  %-32s %6zu -> %6u bytes  %8.1f us/commit (best %.1f)  tree %08x\n", path, size,
+		   fdt_get_total_size(fixup), total / 1000.0 / loops, best / 1000.0, tree_hash(fixup));
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int loops = 1000;
+	int			 i = 1, ret = 0;
+
+	if (argc > 2 && !strcmp(argv[1], "-n")) {
+		loops = strtoul(argv[2], NULL, 0);
+		i	  = 3;
+	}
+	if (i >= argc || !loops) {
+		fprintf(stderr, "usage: %s [-n loops] file.dtb...\n", argv[0]);
+		return 2;
+	}
+
+	for (; i < argc; i++)
+		ret |= bench(argv[i], loops);
+
+	return ret ? 1 : 0;
+}
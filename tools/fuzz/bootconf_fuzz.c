@@ -0,0 +1,128 @@
+/*
+ * Fuzz target for the boot config parsers in lib/bootconf.c.
+ *
+ * The input stands for every config file: its first byte picks the text
+ * files (boot.cfg, the .state and the slot .cfg) when even, or boot.bin
+ * when odd, the rest is the file content. boot.bin gets its CRC fixed up
+ * so the parser past the check is reached.
+ *
+ * libFuzzer: make fuzz FUZZ_CC=clang FUZZ_FLAGS="-g -O1 -fsanitize=fuzzer,address"
+ * Otherwise each file given, or stdin, is run once, for AFL
+ * (make fuzz FUZZ_CC=afl-clang-fast) or to replay a crash.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bootbin.h"
+#include "bootconf.h"
+
+#define MAX_INPUT_SIZE 4096
+
+static const uint8_t *input;
+static size_t		  input_size;
+static bool			  input_bin;
+
+// Replaces the FatFs backed one from lib/loaders.c
+int read_file_max(const char *filename, uint8_t *dest, unsigned int size)
+{
+	bootbin_header_t *hdr = (bootbin_header_t *)dest;
+
+	if (!filename || !strcmp(filename, "boot.bin") != input_bin)
+		return -1;
+
+	if (input_bin) {
+		if (size < BOOTBIN_SIZE)
+			return -1;
+		memset(dest, 0, BOOTBIN_SIZE);
+		memcpy(dest, input, min(input_size, BOOTBIN_SIZE));
+		hdr->crc = 0;
+		hdr->crc = bootbin_crc32(0, dest, BOOTBIN_SIZE);
+		return BOOTBIN_SIZE;
+	}
+
+	// As the real one, files larger than the buffer are rejected
+	if (input_size > size)
+		return -1;
+	memcpy(dest, input, input_size);
+
+	return input_size;
+}
+
+static void check_string(const char *name, const char *s, size_t size)
+{
+	if (strnlen(s, size) >= size) {
+		fprintf(stderr, "slot %s not terminated\n", name);
+		abort();
+	}
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	slot_t slot;
+	char   name[] = "?.cfg";
+
+	if (!size)
+		return 0;
+
+	input_bin  = data[0] & 1;
+	input	   = data + 1;
+	input_size = size - 1;
+
+	bootconf_load_bin("boot.bin");
+	name[0] = bootconf_get_slot("boot.cfg");
+	bootconf_is_slot_state_good("A.state");
+
+	if (bootconf_load_slot_data(name, &slot) == 0) {
+		check_string("dtb", slot.dtb_filename, sizeof(slot.dtb_filename));
+		check_string("kernel", slot.kernel_filename, sizeof(slot.kernel_filename));
+		check_string("initrd", slot.initrd_filename, sizeof(slot.initrd_filename));
+		check_string("args", slot.kernel_cmd, sizeof(slot.kernel_cmd));
+		check_string("overlays", slot.overlays, sizeof(slot.overlays));
+	}
+
+	return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+static int run(FILE *f, const char *name)
+{
+	static uint8_t buf[MAX_INPUT_SIZE];
+	size_t		   len = fread(buf, 1, sizeof(buf), f);
+
+	if (ferror(f)) {
+		fprintf(stderr, "can't read %s\n", name);
+		return 1;
+	}
+
+	// Copied so the sanitizers catch reads past the input
+	uint8_t *data = malloc(len ? len : 1);
+	memcpy(data, buf, len);
+	LLVMFuzzerTestOneInput(data, len);
+	free(data);
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int i, ret = 0;
+
+	if (argc < 2)
+		return run(stdin, "stdin");
+
+	for (i = 1; i < argc; i++) {
+		FILE *f = fopen(argv[i], "rb");
+
+		if (!f) {
+			fprintf(stderr, "can't open %s\n", argv[i]);
+			ret = 1;
+			continue;
+		}
+		ret |= run(f, argv[i]);
+		fclose(f);
+	}
+
+	return ret;
+}
+#endif
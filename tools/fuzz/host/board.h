@@ -0,0 +1,27 @@
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+/* Host stand-in for board.h and lib/common.h, enough for lib/bootconf.c */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define CONFIG_BOOT_SDCARD
+
+// As in lib/common.h, terminator included
+#define MAX_CMD_SIZE	  128
+#define MAX_FILENAME_SIZE 32
+
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+
+#define trace(...)
+#define debug(...)
+#define info(...)
+#define warning(...)
+#define error(...)
+
+typedef struct image_info image_info_t;
+
+#endif
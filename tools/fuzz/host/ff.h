@@ -0,0 +1,10 @@
+#ifndef __FF_DEFINED
+#define __FF_DEFINED
+
+/* Host stand-in for lib/fatfs/ff.h */
+
+#include <stdint.h>
+
+typedef uint8_t BYTE;
+
+#endif
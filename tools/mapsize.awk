@@ -0,0 +1,78 @@
+#
+# Per module memory usage from a GNU ld map file: bytes each object takes
+# in SRAM (code, data, bss and the load image of its DRAM code) and in DRAM
+# once main() has copied the DRAM code up.
+#
+# Usage: awk -f tools/mapsize.awk awboot-boot.map
+#
+
+function module(file)
+{
+	sub(/^.*\//, "", file)
+	return file
+}
+
+function account(name, size, file,    m)
+{
+	if (section == "" || size == 0)
+		return
+	m = file == "" ? "(padding)" : module(file)
+	if (section ~ /^\.(text|ARM\.exidx|data|bss)$/) {
+		sram[m] += size
+	} else if (section ~ /^\.(text|data)\.dram$/) {
+		sram[m] += size
+		dram[m] += size
+	} else if (section == ".bss.dram") {
+		dram[m] += size
+	} else {
+		return
+	}
+	seen[m] = 1
+}
+
+/^Linker script and memory map/ { started = 1; next }
+!started { next }
+
+# Output section, its name alone on the line when too long
+/^\.[^ ]+/ {
+	section = $1
+	next
+}
+/^[^ ]/ { section = ""; next }
+
+# Input section wrapped after a long name
+pending != "" {
+	if ($1 ~ /^0x/ && $2 ~ /^0x/)
+		account(pending, strtonum_hex($2), $3)
+	pending = ""
+	next
+}
+
+/^ \.[^ ]+$/ { pending = $1; next }
+
+/^ [^ ]+ +0x[0-9a-f]+ +0x[0-9a-f]+/ {
+	account($1, strtonum_hex($3), $1 == "*fill*" ? "" : $4)
+	next
+}
+
+function strtonum_hex(s,    n, i, c)
+{
+	n = 0
+	s = tolower(substr(s, 3))
+	for (i = 1; i <= length(s); i++) {
+		c = index("0123456789abcdef", substr(s, i, 1)) - 1
+		n = n * 16 + c
+	}
+	return n
+}
+
+END {
+	printf "  %-24s %7s %7s\n", "module", "SRAM", "DRAM"
+	for (m in seen) {
+		printf "  %-24s %7u %7u\n", m, sram[m], dram[m] | "sort -k2 -nr"
+		total_sram += sram[m]
+		total_dram += dram[m]
+	}
+	close("sort -k2 -nr")
+	printf "  %-24s %7u %7u\n", "total", total_sram, total_dram
+}
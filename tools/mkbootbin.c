@@ -0,0 +1,203 @@
+/*
+ * Build boot.bin from the boot.cfg, X.state and X.cfg text files,
+ * see lib/bootbin.h for the format.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "bootbin.h"
+
+// As in lib/common.h, terminator included
+#define MAX_CMD_SIZE	  128
+#define MAX_FILENAME_SIZE 32
+
+static const char slot_names[BOOTBIN_SLOTS] = {'R', 'A', 'B'};
+
+static uint8_t	sector[BOOTBIN_SIZE];
+static uint16_t pool = sizeof(bootbin_header_t);
+
+static char *read_text(const char *dir, const char *name)
+{
+	char  path[1024];
+	char *buffer;
+	long  size;
+	FILE *fp;
+
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+	fp = fopen(path, "rb");
+	if (!fp)
+		return NULL;
+
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	buffer = calloc(1, size + 1);
+	if (!buffer || fread(buffer, 1, size, fp) != (size_t)size) {
+		printf("Can't read %s\n", path);
+		exit(1);
+	}
+	fclose(fp);
+
+	return buffer;
+}
+
+// Value of the last "key=value" line, same rules as lib/bootconf.c
+static const char *get_value(const char *text, const char *key, char *value, size_t size)
+{
+	const char *line  = text;
+	const char *found = NULL;
+	const char *end;
+	size_t		len;
+
+	while (line && *line) {
+		line += strspn(line, " \t");
+
+		len = strlen(key);
+		if (*line != '#' && !strncmp(line, key, len) && strchr("= \t", line[len])) {
+			end = line + len + strspn(line + len, " \t");
+			if (*end == '=') {
+				line = end + 1 + strspn(end + 1, " \t");
+				end	 = line + strcspn(line, "\r\n");
+				while (end > line && strchr(" \t\r", end[-1]))
+					end--;
+				// Quoted values end at the closing quote, unterminated ones are skipped
+				if (end > line && *line == '"') {
+					line++;
+					end = memchr(line, '"', end - line);
+				}
+				if (end) {
+					len = end - line;
+					if (len >= size) {
+						printf("Value of %s is longer than %zu bytes\n", key, size - 1);
+						exit(1);
+					}
+					memcpy(value, line, len);
+					value[len] = '\0';
+					found	   = value;
+				}
+			}
+		}
+
+		line = strchr(line, '\n');
+		if (line)
+			line++;
+	}
+
+	return found;
+}
+
+// Store a string once in the sector and return its offset
+static uint16_t add_string(const char *text, const char *key, size_t size)
+{
+	char	 value[MAX_CMD_SIZE];
+	uint16_t offset;
+	size_t	 len;
+
+	if (!get_value(text, key, value, size) || !value[0])
+		return 0;
+
+	for (offset = sizeof(bootbin_header_t); offset < pool; offset += strlen((char *)&sector[offset]) + 1) {
+		if (!strcmp((char *)&sector[offset], value))
+			return offset;
+	}
+
+	len = strlen(value) + 1;
+	if (pool + len > BOOTBIN_SIZE) {
+		printf("Strings do not fit in %u bytes\n", BOOTBIN_SIZE);
+		exit(1);
+	}
+	memcpy(&sector[pool], value, len);
+	offset = pool;
+	pool += len;
+
+	return offset;
+}
+
+static uint8_t get_state(const char *text)
+{
+	const char *line = text;
+
+	while (line && *line) {
+		while (*line == ' ')
+			line++;
+
+		if (!strncmp(line, "bad", 3) && strchr(" \t\r\n", line[3]))
+			return BOOTBIN_STATE_BAD;
+		if (!strncmp(line, "good", 4) && strchr(" \t\r\n", line[4]))
+			return BOOTBIN_STATE_GOOD;
+
+		line = strchr(line, '\n');
+		if (line)
+			line++;
+	}
+
+	return BOOTBIN_STATE_BAD;
+}
+
+int main(int argc, char *argv[])
+{
+	bootbin_header_t *hdr = (bootbin_header_t *)sector;
+	bootbin_slot_t	 *slot;
+	char			  name[16], value[4];
+	char			 *text;
+	FILE			 *fp;
+	int				  i;
+
+	if (argc != 3) {
+		printf("Usage: %s <config dir> <boot.bin>\n", argv[0]);
+		printf("Reads boot.cfg, R.cfg, A.cfg, B.cfg, A.state and B.state\n");
+		return 1;
+	}
+
+	hdr->magic	 = BOOTBIN_MAGIC;
+	hdr->version = BOOTBIN_VERSION;
+	hdr->active	 = 'R';
+
+	text = read_text(argv[1], "boot.cfg");
+	if (text && get_value(text, "slot", value, sizeof(value)))
+		hdr->active = value[0];
+	free(text);
+
+	for (i = 0; i < BOOTBIN_SLOTS; i++) {
+		slot = &hdr->slots[i];
+
+		snprintf(name, sizeof(name), "%c.cfg", slot_names[i]);
+		text = read_text(argv[1], name);
+		if (!text) {
+			printf("No %s, slot %c left empty\n", name, slot_names[i]);
+			continue;
+		}
+		slot->kernel	= add_string(text, "kernel", MAX_FILENAME_SIZE);
+		slot->dtb		= add_string(text, "dtb", MAX_FILENAME_SIZE);
+		slot->initrd	= add_string(text, "initrd", MAX_FILENAME_SIZE);
+		slot->args		= add_string(text, "args", MAX_CMD_SIZE);
+		slot->overlays	= add_string(text, "overlays", MAX_CMD_SIZE);
+		slot->root_part = get_value(text, "rootpart", value, sizeof(value)) ? atoi(value) : 0;
+		free(text);
+
+		// Recovery has no state file, it is good when configured
+		slot->state = BOOTBIN_STATE_GOOD;
+		if (slot_names[i] != 'R') {
+			snprintf(name, sizeof(name), "%c.state", slot_names[i]);
+			text		= read_text(argv[1], name);
+			slot->state = text ? get_state(text) : BOOTBIN_STATE_BAD;
+			free(text);
+		}
+	}
+
+	hdr->crc = bootbin_crc32(0, sector, sizeof(sector));
+
+	fp = fopen(argv[2], "wb");
+	if (!fp || fwrite(sector, 1, sizeof(sector), fp) != sizeof(sector)) {
+		printf("Can't write %s\n", argv[2]);
+		return 1;
+	}
+	fclose(fp);
+
+	printf("%s: slot %c, %u bytes used\n", argv[2], hdr->active, pool);
+
+	return 0;
+}
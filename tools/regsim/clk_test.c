@@ -0,0 +1,86 @@
+/*
+ * mach-t113s3/sunxi_clk.c on the register model: the CPU PLL lock wait,
+ * the fallback to the next CPU step and the bus dividers.
+ */
+
+#include "regsim.h"
+#include "test.h"
+#include "board.h"
+#include "sunxi_clk.h"
+#include "reg-ccu.h"
+
+#define PLL_CPU	  (T113_CCU_BASE + CCU_PLL_CPU_CTRL_REG)
+#define PLL_PERI0 (T113_CCU_BASE + CCU_PLL_PERI0_CTRL_REG)
+#define PLL_EN	  (1U << 31)
+#define PLL_LOCK  (1U << 28)
+#define PLL_GATE  (1U << 27)
+
+#define MHZ(x) ((x) * 1000000U)
+
+// Lock bit following the enable bit, for the rate in arg only when set
+static void pll_write(uint32_t addr, uint32_t value, void *arg)
+{
+	const uint32_t *lock_mhz = arg;
+	uint32_t		mhz		 = (((value >> 8) & 0xff) + 1) * 24;
+
+	if ((value & PLL_EN) && (!lock_mhz || *lock_mhz == mhz))
+		regsim_poke(addr, value | PLL_LOCK);
+	else
+		regsim_poke(addr, value & ~PLL_LOCK);
+}
+
+static const sunxi_clk_plan_t *run(uint32_t *lock_mhz)
+{
+	regsim_reset();
+	// Left running by the boot ROM: N = 100, P0 = 2, 600MHz PLL_PERI(1x)
+	regsim_poke(PLL_PERI0, 0xe8216300 | PLL_LOCK);
+	regsim_on_write(PLL_CPU, pll_write, lock_mhz);
+
+	sunxi_clk_init();
+
+	return sunxi_clk_get_plan();
+}
+
+static void check_buses(const char *name, const sunxi_clk_plan_t *plan)
+{
+	// PLL_PERI(1x) is 600MHz: PSI / 3, APB0 and APB1 / 6
+	CHECK_EQ(name, plan->psi, MHZ(200));
+	CHECK_EQ(name, plan->apb0, MHZ(100));
+	CHECK_EQ(name, plan->apb1, MHZ(100));
+	CHECK_EQ(name, regsim_peek(T113_CCU_BASE + CCU_PSI_CLK_REG), 0x03000002);
+	CHECK_EQ(name, regsim_peek(T113_CCU_BASE + CCU_APB0_CLK_REG), 0x03000005);
+	CHECK_EQ(name, regsim_peek(T113_CCU_BASE + CCU_APB1_CLK_REG), 0x03000005);
+}
+
+int main(void)
+{
+	const sunxi_clk_plan_t *plan;
+	uint32_t				lock_mhz;
+
+	plan = run(NULL);
+	CHECK_EQ("lock", plan->cpu, CONFIG_CPU_FREQ);
+	CHECK_EQ("lock", plan->axi, CONFIG_CPU_FREQ / 2);
+	CHECK_EQ("lock", regsim_peek(PLL_CPU) & (PLL_EN | PLL_LOCK | PLL_GATE), PLL_EN | PLL_LOCK | PLL_GATE);
+	CHECK_EQ("lock", regsim_peek(T113_CCU_BASE + CCU_CPU_AXI_CFG_REG), 0x03000101);
+	check_buses("lock", plan);
+
+	// Only the last step, 792MHz, locks
+	lock_mhz = 792;
+	plan	 = run(&lock_mhz);
+	CHECK_EQ("fallback", plan->cpu, MHZ(792));
+	CHECK_EQ("fallback", plan->axi, MHZ(396));
+	CHECK_EQ("fallback", (regsim_peek(PLL_CPU) >> 8) & 0xff, 792 / 24 - 1);
+	CHECK_EQ("fallback", regsim_peek(PLL_CPU) & PLL_GATE, PLL_GATE);
+	check_buses("fallback", plan);
+
+	// No lock at all, the CPU stays on PLL_PERI(1x) with the gate closed
+	lock_mhz = 1; // none of the steps
+	plan	 = run(&lock_mhz);
+	CHECK_EQ("no lock", plan->cpu, MHZ(600));
+	CHECK_EQ("no lock", plan->axi, MHZ(300));
+	CHECK_EQ("no lock", regsim_peek(PLL_CPU) & PLL_GATE, 0);
+	CHECK_EQ("no lock", regsim_peek(T113_CCU_BASE + CCU_CPU_AXI_CFG_REG), 0x04000001);
+	check_buses("no lock", plan);
+
+	return test_result("clk_test");
+}
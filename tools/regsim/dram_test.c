@@ -0,0 +1,67 @@
+/*
+ * mach-t113s3/dram.c size scan on the register model: DRAM that wraps
+ * around at its size, like missing address lines, must be found with the
+ * matching row count.
+ */
+
+#include "regsim.h"
+#include "test.h"
+
+// Built in, for the static functions
+#include "dram.c"
+
+#undef printf
+
+#define DRAM_MAX MB(128)
+
+// Needed by the profile code, unused by the size scan
+const dram_profile_t dram_profiles[] = {{"test", {0}}};
+const unsigned int	 dram_profile_count = 1;
+
+int board_get_dram_profile(void)
+{
+	return -1;
+}
+
+static uint8_t dram[DRAM_MAX];
+
+static void check_size(unsigned int size_mb, unsigned int rows)
+{
+	char		name[16];
+	dram_para_t para = {
+		.dram_clk	= 792,
+		.dram_type	= SUNXI_DRAM_TYPE_DDR3,
+		.dram_para1 = 0x000010d2,
+		.dram_tpr13 = 0x34000100,
+	};
+
+	snprintf(name, sizeof(name), "%uMB", size_mb);
+
+	regsim_reset();
+	memset(dram, 0, sizeof(dram));
+	// The scan reads up to 128MB and past, beyond the DRAM size
+	regsim_memory(SDRAM_BASE, MB(256), dram, MB(size_mb));
+
+	// PLL_DDR lock, PHY init done and normal state
+	regsim_poke(T113_CCU_BASE + CCU_PLL_DDR_CTRL_REG, 1 << 28);
+	regsim_readonly(T113_CCU_BASE + CCU_PLL_DDR_CTRL_REG, 1 << 28);
+	regsim_poke(MCTL_PHY_BASE + MCTL_PHY_PGSR0, 1 << 0);
+	regsim_readonly(MCTL_PHY_BASE + MCTL_PHY_PGSR0, 1 << 0);
+	regsim_poke(MCTL_PHY_BASE + MCTL_PHY_STATR, 1 << 0);
+	regsim_readonly(MCTL_PHY_BASE + MCTL_PHY_STATR, 1 << 0);
+
+	CHECK_EQ(name, auto_scan_dram_size(&para), 1);
+	// Rows in bits 7:4, bank 8 in bits 15:12 and page 8KB in bits 3:0,
+	// the bank and column addresses are below the wrap
+	CHECK_EQ(name, para.dram_para1 & 0xffff, 0x1008 | rows << 4);
+}
+
+int main(void)
+{
+	check_size(16, 13);
+	check_size(32, 14);
+	check_size(64, 15);
+	check_size(128, 16);
+
+	return test_result("dram_test");
+}
@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "regsim.h"
+
+#define MAX_REGS	 1024
+#define MAX_MEMORIES 4
+
+typedef struct {
+	uint32_t	  addr;
+	uint32_t	  value;
+	uint32_t	  w1c;
+	uint32_t	  readonly;
+	uint32_t	  trigger; // set_when
+	uint32_t	  status;
+	uint32_t	  set;
+	regsim_hook_t hook;
+	void		 *arg;
+} reg_t;
+
+typedef struct {
+	uint32_t base;
+	uint32_t window;
+	uint8_t *buf;
+	uint32_t size;
+} memory_t;
+
+static reg_t		  regs[MAX_REGS];
+static unsigned int	  reg_count;
+static memory_t		  memories[MAX_MEMORIES];
+static unsigned int	  memory_count;
+static regsim_stats_t stats;
+static uint32_t		  last_addr, last_value;
+
+void regsim_reset(void)
+{
+	memset(regs, 0, sizeof(regs));
+	memset(memories, 0, sizeof(memories));
+	memset(&stats, 0, sizeof(stats));
+	reg_count	 = 0;
+	memory_count = 0;
+	last_addr	 = 0;
+	last_value	 = 0;
+}
+
+static reg_t *reg_get(uint32_t addr)
+{
+	unsigned int i;
+
+	addr &= ~3U;
+	for (i = 0; i < reg_count; i++) {
+		if (regs[i].addr == addr)
+			return &regs[i];
+	}
+
+	if (reg_count == MAX_REGS) {
+		printf("regsim: more than %u registers\n", MAX_REGS);
+		exit(1);
+	}
+	regs[reg_count].addr = addr;
+
+	return &regs[reg_count++];
+}
+
+void regsim_poke(uint32_t addr, uint32_t value)
+{
+	reg_get(addr)->value = value;
+}
+
+uint32_t regsim_peek(uint32_t addr)
+{
+	return reg_get(addr)->value;
+}
+
+void regsim_w1c(uint32_t addr, uint32_t mask)
+{
+	reg_get(addr)->w1c |= mask;
+}
+
+void regsim_readonly(uint32_t addr, uint32_t mask)
+{
+	reg_get(addr)->readonly |= mask;
+}
+
+void regsim_set_when(uint32_t addr, uint32_t trigger, uint32_t status, uint32_t set)
+{
+	reg_t *reg = reg_get(addr);
+
+	reg->trigger = trigger;
+	reg->status	 = status;
+	reg->set	 = set;
+}
+
+void regsim_on_write(uint32_t addr, regsim_hook_t hook, void *arg)
+{
+	reg_t *reg = reg_get(addr);
+
+	reg->hook = hook;
+	reg->arg  = arg;
+}
+
+void regsim_memory(uint32_t base, uint32_t window, void *buf, uint32_t size)
+{
+	if (memory_count == MAX_MEMORIES) {
+		printf("regsim: more than %u memories\n", MAX_MEMORIES);
+		exit(1);
+	}
+	memories[memory_count].base	  = base;
+	memories[memory_count].window = window;
+	memories[memory_count].buf	  = buf;
+	memories[memory_count].size	  = size;
+	memory_count++;
+}
+
+void *regsim_host_ptr(uint32_t addr)
+{
+	unsigned int i;
+
+	for (i = 0; i < memory_count; i++) {
+		if (addr - memories[i].base < memories[i].window)
+			return memories[i].buf + (addr - memories[i].base) % memories[i].size;
+	}
+
+	return NULL;
+}
+
+const regsim_stats_t *regsim_stats(void)
+{
+	return &stats;
+}
+
+static uint32_t reg_read(uint32_t addr)
+{
+	reg_t	*reg   = reg_get(addr);
+	uint32_t value = reg->value;
+
+	stats.reads++;
+	if (reg->addr == last_addr && value == last_value)
+		stats.polls++;
+	last_addr  = reg->addr;
+	last_value = value;
+
+	return value;
+}
+
+static void reg_write(uint32_t addr, uint32_t value)
+{
+	reg_t	*reg = reg_get(addr);
+	uint32_t keep;
+
+	stats.writes++;
+
+	keep	   = reg->readonly | reg->w1c;
+	reg->value = (reg->value & keep) | (value & ~keep);
+	reg->value &= ~(value & reg->w1c);
+
+	if (reg->trigger && (value & reg->trigger) == reg->trigger)
+		reg_get(reg->status)->value |= reg->set;
+
+	if (reg->hook)
+		reg->hook(reg->addr, reg->value, reg->arg);
+}
+
+uint64_t io_model_read(uint32_t addr, unsigned int width)
+{
+	uint8_t		*mem = regsim_host_ptr(addr);
+	uint64_t	 value;
+	unsigned int shift;
+
+	if (mem) {
+		value = 0;
+		memcpy(&value, mem, width / 8);
+		return value;
+	}
+
+	if (width == 64)
+		return reg_read(addr) | ((uint64_t)reg_read(addr + 4) << 32);
+
+	shift = (addr & 3) * 8;
+	value = reg_read(addr) >> shift;
+
+	return width == 32 ? value : value & ((1U << width) - 1);
+}
+
+void io_model_write(uint32_t addr, uint64_t value, unsigned int width)
+{
+	uint8_t *mem = regsim_host_ptr(addr);
+	uint32_t mask, shift;
+
+	if (mem) {
+		memcpy(mem, &value, width / 8);
+		return;
+	}
+
+	if (width == 64) {
+		reg_write(addr, value);
+		reg_write(addr + 4, value >> 32);
+		return;
+	}
+	if (width == 32) {
+		reg_write(addr, value);
+		return;
+	}
+
+	// Narrow writes update their lanes of the register
+	shift = (addr & 3) * 8;
+	mask  = ((1U << width) - 1) << shift;
+	reg_write(addr, (reg_get(addr)->value & ~mask) | (((uint32_t)value << shift) & mask));
+}
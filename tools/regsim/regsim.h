@@ -0,0 +1,45 @@
+#ifndef __REGSIM_H__
+#define __REGSIM_H__
+
+/*
+ * Register model for running the arch drivers on the host. Build the
+ * driver sources with -DCONFIG_IO_MODEL so include/io.h routes read32(),
+ * write32() and friends here (and -m32, or -no-pie with static buffers, for
+ * drivers handing pointers to DMA), then describe the hardware the driver
+ * polls with the calls below.
+ * make check runs the tests in this directory, see test.h.
+ */
+
+#include <stdint.h>
+
+typedef void (*regsim_hook_t)(uint32_t addr, uint32_t value, void *arg);
+
+typedef struct {
+	unsigned long reads;
+	unsigned long writes;
+	unsigned long polls; // reads returning the same value as the previous read
+} regsim_stats_t;
+
+void regsim_reset(void);
+
+// Register values, without side effects
+void	 regsim_poke(uint32_t addr, uint32_t value);
+uint32_t regsim_peek(uint32_t addr);
+
+// Bits in mask are cleared by writing 1 (interrupt status)
+void regsim_w1c(uint32_t addr, uint32_t mask);
+// Bits in mask keep their value on writes (status, lock bits)
+void regsim_readonly(uint32_t addr, uint32_t mask);
+// Writing trigger bits to addr sets the set bits in status (PLL enable then lock)
+void regsim_set_when(uint32_t addr, uint32_t trigger, uint32_t status, uint32_t set);
+// Called after every write to addr, scripts command completion, DMA...
+void regsim_on_write(uint32_t addr, regsim_hook_t hook, void *arg);
+
+// Memory at base backed by buf, accesses up to base + window wrap around
+// size like a DRAM with missing address lines
+void  regsim_memory(uint32_t base, uint32_t window, void *buf, uint32_t size);
+void *regsim_host_ptr(uint32_t addr);
+
+const regsim_stats_t *regsim_stats(void);
+
+#endif
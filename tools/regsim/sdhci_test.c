@@ -0,0 +1,213 @@
+/*
+ * sunxi/sunxi_sdhci.c sdhci_transfer() on the register model: commands
+ * complete through RINT, block reads go through the IDMAC descriptor chain
+ * into the host buffer, and a missing completion fails the transfer.
+ */
+
+#include "regsim.h"
+#include "test.h"
+#include "common.h"
+#include "sdmmc.h"
+#include "sunxi_sdhci.h"
+
+#define SMHC_BASE 0x04020000
+#define SMHC(reg) (SMHC_BASE + offsetof(sdhci_reg_t, reg))
+
+#define CMD_RESP_EXPIRE (1U << 6)
+#define CMD_CHECK_CRC	(1U << 8)
+#define CMD_DATA_EXPIRE (1U << 9)
+#define CMD_AUTO_STOP	(1U << 12)
+#define CMD_START		(1U << 31)
+
+#define RINT_COMMAND_DONE	   (1U << 2)
+#define RINT_DATA_OVER		   (1U << 3)
+#define RINT_RESP_TIMEOUT	   (1U << 8)
+#define RINT_AUTO_COMMAND_DONE (1U << 14)
+
+#define GCTRL_DMA_ENABLE (1U << 5)
+#define IDMAC_SOFT_RESET (1U << 0)
+#define IDST_RX			 (1U << 1)
+
+#define R1_TRAN 0x00000900 // READY_FOR_DATA, state tran
+
+#define BLOCKS	 16
+#define GUARD	 64
+#define SENTINEL 0xa5
+
+// What the card answers
+static struct {
+	uint32_t	 rint_fail; // error bits instead of the command completion
+	int			 idmac_stuck; // the IDMAC never raises its RX interrupt
+	unsigned int descs; // descriptors walked by the last transfer
+	uint32_t	 cmd; // last command register value
+} card;
+
+static uint8_t card_data[BLOCKS * 512];
+
+// Static, so the driver can hand their addresses to the 32 bit IDMAC
+static sdhci_t sdhci = {
+	.name  = "sdhci0",
+	.reg   = (sdhci_reg_t *)SMHC_BASE,
+	.clock = MMC_CLK_50M,
+};
+static uint8_t buf[BLOCKS * 512 + GUARD] __attribute__((aligned(4)));
+
+// Needed by sunxi_sdhci_init() and sdhci_set_clock(), unused here
+void sunxi_gpio_init(gpio_t pin, unsigned int cfg)
+{
+}
+
+void sunxi_gpio_set_pull(gpio_t pin, enum gpio_pull_t pull)
+{
+}
+
+uint32_t sunxi_clk_get_peri1x_rate(void)
+{
+	return 600000000;
+}
+
+void udelay(uint64_t us)
+{
+}
+
+// Walks the descriptor chain from DLBA like the IDMAC, copying the card data
+// from the block in the argument. The 32 bit bus moves whole words, so a
+// buffer size is rounded up to 4 bytes.
+static void idmac_read(uint32_t block)
+{
+	sdhci_idma_desc_t *desc	 = (sdhci_idma_desc_t *)(uintptr_t)(regsim_peek(SMHC(dlba)) << 2);
+	uint32_t		   count = regsim_peek(SMHC(bytecnt));
+	const uint8_t	  *src	 = card_data + block * 512;
+	uint32_t		   len;
+
+	card.descs = 0;
+	while (desc && desc->own && count) {
+		len = (desc->data_buf_sz + 3) & ~3;
+		if (len > count)
+			len = count;
+		memcpy((void *)(uintptr_t)(desc->buf_addr << 2), src, len);
+		src += len;
+		count -= len;
+		desc->own = 0;
+		card.descs++;
+		if (desc->last_desc)
+			break;
+		desc = (sdhci_idma_desc_t *)(uintptr_t)(desc->next_desc_addr << 2);
+	}
+
+	if (!card.idmac_stuck)
+		regsim_poke(SMHC(idst), regsim_peek(SMHC(idst)) | IDST_RX);
+}
+
+static void cmd_write(uint32_t addr, uint32_t value, void *arg)
+{
+	uint32_t rint;
+
+	if (!(value & CMD_START))
+		return;
+	card.cmd = value;
+	regsim_poke(addr, value & ~CMD_START);
+
+	if (card.rint_fail) {
+		regsim_poke(SMHC(rint), card.rint_fail);
+		return;
+	}
+
+	regsim_poke(SMHC(resp0), R1_TRAN);
+	rint = RINT_COMMAND_DONE;
+	if (value & CMD_DATA_EXPIRE) {
+		if (regsim_peek(SMHC(gctrl)) & GCTRL_DMA_ENABLE)
+			idmac_read(regsim_peek(SMHC(arg)));
+		rint |= RINT_DATA_OVER;
+		if (value & CMD_AUTO_STOP)
+			rint |= RINT_AUTO_COMMAND_DONE;
+	}
+	regsim_poke(SMHC(rint), rint);
+}
+
+static void setup(void)
+{
+	regsim_reset();
+	memset(&card, 0, sizeof(card));
+	memset(buf, SENTINEL, sizeof(buf));
+
+	regsim_w1c(SMHC(rint), 0xffffffff);
+	regsim_w1c(SMHC(idst), 0x337);
+	// The IDMAC reset is over by the time it is read back
+	regsim_readonly(SMHC(dmac), IDMAC_SOFT_RESET);
+	regsim_on_write(SMHC(cmd), cmd_write, NULL);
+}
+
+static int send_status(void)
+{
+	sdhci_cmd_t cmd = {.idx = MMC_SEND_STATUS, .arg = 1 << 16, .resptype = MMC_RSP_R1};
+
+	if (!sdhci_transfer(&sdhci, &cmd, NULL))
+		return -1;
+	return cmd.response[0];
+}
+
+static int read_blocks(uint32_t block, uint32_t count)
+{
+	sdhci_cmd_t	 cmd = {.arg = block, .resptype = MMC_RSP_R1};
+	sdhci_data_t dat = {.buf = buf, .flag = MMC_DATA_READ, .blksz = 512, .blkcnt = count};
+
+	cmd.idx = count > 1 ? MMC_READ_MULTIPLE_BLOCK : MMC_READ_SINGLE_BLOCK;
+
+	return sdhci_transfer(&sdhci, &cmd, &dat) ? 0 : -1;
+}
+
+static int buf_untouched(const uint8_t *p, unsigned int len)
+{
+	while (len--) {
+		if (*p++ != SENTINEL)
+			return 0;
+	}
+	return 1;
+}
+
+static void check_read(const char *name, uint32_t block, uint32_t count, unsigned int descs)
+{
+	setup();
+	CHECK_EQ(name, read_blocks(block, count), 0);
+	CHECK_EQ(name, memcmp(buf, card_data + block * 512, count * 512), 0);
+	CHECK_EQ(name, buf_untouched(buf + count * 512, GUARD), 1);
+	CHECK_EQ(name, card.descs, descs);
+	CHECK_EQ(name, card.cmd & CMD_AUTO_STOP, count > 1 ? CMD_AUTO_STOP : 0);
+	// IDMAC off again
+	CHECK_EQ(name, regsim_peek(SMHC(dmac)), 0);
+	CHECK_EQ(name, regsim_peek(SMHC(idie)), 0);
+	CHECK_EQ(name, regsim_peek(SMHC(gctrl)) & GCTRL_DMA_ENABLE, 0);
+}
+
+int main(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < sizeof(card_data); i++)
+		card_data[i] = i * 7 + (i >> 9);
+
+	// Command only, the response comes from RESP0
+	setup();
+	CHECK_EQ("status", send_status(), R1_TRAN);
+	CHECK_EQ("status", card.cmd, CMD_START | CMD_CHECK_CRC | CMD_RESP_EXPIRE | MMC_SEND_STATUS);
+
+	check_read("read 1", 3, 1, 1);
+	// Up to 4KB per descriptor, 4095 bytes in the size field
+	check_read("read 8", 0, 8, 1);
+	check_read("read 9", 5, 9, 2);
+	check_read("read 16", 0, 16, 2);
+
+	setup();
+	card.rint_fail = RINT_RESP_TIMEOUT;
+	CHECK_EQ("response timeout", send_status(), -1);
+	CHECK_EQ("response timeout", read_blocks(0, 1), -1);
+	CHECK_EQ("response timeout", buf_untouched(buf, sizeof(buf)), 1);
+
+	// DATA_OVER alone is not the end of a DMA read
+	setup();
+	card.idmac_stuck = 1;
+	CHECK_EQ("idmac stuck", read_blocks(0, 2), -1);
+
+	return test_result("sdhci_test");
+}
@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#include "test.h"
+
+int test_failures;
+
+// The clock moves 1us per reading and with the delays, so timeouts expire
+// without waiting
+static uint64_t now_us;
+
+void sdelay(uint32_t loops)
+{
+	now_us += loops;
+}
+
+uint64_t time_us(void)
+{
+	return ++now_us;
+}
+
+uint32_t time_ms(void)
+{
+	return time_us() / 1000;
+}
+
+void message(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+int test_result(const char *test)
+{
+	printf("  %s %s\n", test_failures ? "FAIL" : "PASS", test);
+
+	return test_failures ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+#ifndef __REGSIM_TEST_H__
+#define __REGSIM_TEST_H__
+
+/*
+ * Shared by the driver tests run by make check: the timing and console
+ * functions the drivers link against, and the result checks.
+ */
+
+#include <stdio.h>
+
+extern int test_failures;
+
+#define CHECK_EQ(name, got, expected)                                                                 \
+	do {                                                                                              \
+		unsigned long long _got = (got), _expected = (expected);                                      \
+		if (_got != _expected) {                                                                      \
+			printf("  FAIL %s: %s = 0x%llx, expected 0x%llx\n", (name), #got, _got, _expected);       \
+			test_failures++;                                                                          \
+		}                                                                                             \
+	} while (0)
+
+// Prints the test result, the exit status of main()
+int test_result(const char *test);
+
+#endif